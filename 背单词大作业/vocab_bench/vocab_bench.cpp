@@ -0,0 +1,359 @@
+﻿// 单词库核心的性能基准：在 4k / 100k / 1M 个合成单词上测量
+//   - 从 JSON 加载词库（与程序启动时的 loadWordLibraryFromJSON 走同一条路径）
+//   - getRandomUnlearnedWord / getRandomLearnedWord
+//   - updateWordStatus
+//   - searchSimilar（拼写相近的查找，编辑距离不超过 2）
+// 每项报告 ns/op、每次操作的内存分配次数和当时的峰值常驻内存，结果以 JSON 输出到标准输出，
+// 进度和可读的摘要输出到标准错误，便于直接重定向保存：vocab_bench > bench.json
+//
+// 参数：
+//   --sizes 4000,100000     只测这些规模（默认 4000,100000,1000000）
+//   --ops N                 每项随机操作的次数（默认 1000000，searchSimilar 取其千分之一，至少 100 次）
+//   --threads N             解析 JSON 使用的线程数（默认 0，自动）
+//   --dir 路径              合成词库文件存放的目录（默认系统临时目录）
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <new>
+#include <random>
+#include <string>
+#include <vector>
+
+#ifdef _WIN32
+#include <windows.h>
+#include <psapi.h>
+#else
+#include <sys/resource.h>
+#endif
+
+#include "json.hpp"
+#include "word_library.h"
+
+using json = nlohmann::ordered_json;
+
+// ---------------- 内存分配计数 ----------------
+// 替换全局 operator new，统计整个进程的分配次数
+
+#if defined(__GNUC__) && !defined(__clang__)
+// 替换后的 new/delete 成对使用 malloc/free，GCC 在内联后会误报不匹配
+#pragma GCC diagnostic ignored "-Wmismatched-new-delete"
+#endif
+
+static std::atomic<size_t> allocationCount(0);
+
+void* operator new(std::size_t size) {
+    allocationCount.fetch_add(1, std::memory_order_relaxed);
+    if (size == 0) size = 1;
+    void* p = std::malloc(size);
+    if (p == nullptr) throw std::bad_alloc();
+    return p;
+}
+
+void* operator new[](std::size_t size) {
+    return operator new(size);
+}
+
+void operator delete(void* p) noexcept {
+    std::free(p);
+}
+
+void operator delete[](void* p) noexcept {
+    std::free(p);
+}
+
+void operator delete(void* p, std::size_t) noexcept {
+    std::free(p);
+}
+
+void operator delete[](void* p, std::size_t) noexcept {
+    std::free(p);
+}
+
+// 进程的峰值常驻内存（KB）
+static size_t peakRssKb() {
+#ifdef _WIN32
+    PROCESS_MEMORY_COUNTERS counters;
+    if (GetProcessMemoryInfo(GetCurrentProcess(), &counters, sizeof(counters))) {
+        return counters.PeakWorkingSetSize / 1024;
+    }
+    return 0;
+#else
+    struct rusage usage;
+    if (getrusage(RUSAGE_SELF, &usage) != 0) return 0;
+#ifdef __APPLE__
+    return static_cast<size_t>(usage.ru_maxrss) / 1024; // macOS 以字节为单位
+#else
+    return static_cast<size_t>(usage.ru_maxrss);
+#endif
+#endif
+}
+
+// ---------------- 合成词库 ----------------
+
+// 生成和 words.json 结构相同的词库：单词为随机字母串，释义从一个有限的集合中抽取
+// （真实词库中的释义也有大量重复），约三成单词带短语
+static uint64_t writeSyntheticDeck(const std::string& path, size_t wordCount) {
+    static const char* const meanings[] = {
+        "放弃", "不正常的", "当然", "抽象的", "学术的", "接受", "事故", "账户", "准确的", "达到",
+        "承认", "获得", "行动", "实际上", "适应", "地址", "足够的", "调整", "管理", "承认",
+        "优势", "冒险", "广告", "建议", "影响", "负担得起", "害怕的", "代理人", "同意", "目标",
+    };
+    static const char* const types[] = { "n", "v", "adj", "adv", "prep" };
+    const size_t meaningCount = sizeof(meanings) / sizeof(meanings[0]);
+
+    std::mt19937 gen(42);
+    std::uniform_int_distribution<int> letter('a', 'z');
+    std::uniform_int_distribution<int> length(4, 12);
+
+    std::ofstream out(path, std::ios::binary | std::ios::trunc);
+    if (!out.is_open()) {
+        throw std::runtime_error("无法创建 " + path);
+    }
+
+    std::string word;
+    out << "[\n";
+    for (size_t i = 0; i < wordCount; i++) {
+        word.clear();
+        int n = length(gen);
+        for (int k = 0; k < n; k++) word += static_cast<char>(letter(gen));
+
+        out << "  {\n    \"word\": \"" << word << "\",\n    \"translations\": [\n";
+        int translationCount = 1 + static_cast<int>(gen() % 3);
+        for (int t = 0; t < translationCount; t++) {
+            out << "      {\n        \"translation\": \"" << meanings[gen() % meaningCount]
+                << "\",\n        \"type\": \"" << types[gen() % 5] << "\"\n      }"
+                << (t + 1 < translationCount ? ",\n" : "\n");
+        }
+        out << "    ]";
+        if (gen() % 10 < 3) {
+            out << ",\n    \"phrases\": [\n      {\n        \"phrase\": \"" << word << " example\",\n"
+                << "        \"translation\": \"" << meanings[gen() % meaningCount] << "\"\n      }\n    ]";
+        }
+        out << "\n  }" << (i + 1 < wordCount ? ",\n" : "\n");
+    }
+    out << "]\n";
+    out.close();
+    return std::filesystem::file_size(path);
+}
+
+// ---------------- 计时 ----------------
+
+struct BenchResult {
+    std::string name;
+    size_t ops;
+    double nsPerOp;
+    double allocationsPerOp;
+    size_t peakRssKb;
+};
+
+class Stopwatch {
+private:
+    std::chrono::steady_clock::time_point start;
+    size_t startAllocations;
+
+public:
+    Stopwatch() : start(std::chrono::steady_clock::now()), startAllocations(allocationCount.load()) {}
+
+    // name 用字符串常量，避免在计时区间内构造 std::string
+    BenchResult finish(const char* name, size_t ops) const {
+        double ns = std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - start).count();
+        size_t allocations = allocationCount.load() - startAllocations;
+        BenchResult r;
+        r.name = name;
+        r.ops = ops;
+        r.nsPerOp = ns / static_cast<double>(ops);
+        r.allocationsPerOp = static_cast<double>(allocations) / static_cast<double>(ops);
+        r.peakRssKb = peakRssKb();
+        return r;
+    }
+};
+
+// 防止编译器把被测调用的结果优化掉
+static volatile int64_t sink;
+
+static void report(const BenchResult& r) {
+    std::fprintf(stderr, "  %-24s %12.1f ns/op  %8.3f 次分配/op  峰值内存 %zu KB\n",
+        r.name.c_str(), r.nsPerOp, r.allocationsPerOp, r.peakRssKb);
+}
+
+// 在一个规模上运行全部测量
+static json runSize(size_t wordCount, size_t ops, unsigned threads, const std::filesystem::path& dir) {
+    std::string path = (dir / ("vocab_bench_" + std::to_string(wordCount) + ".json")).string();
+    std::fprintf(stderr, "生成 %zu 个单词的合成词库...\n", wordCount);
+    uint64_t fileBytes = writeSyntheticDeck(path, wordCount);
+
+    std::vector<BenchResult> results;
+
+    // 加载：重复若干次取平均，小词库多测几次以减小误差
+    {
+        size_t loads = std::max<size_t>(3, std::min<size_t>(200, 2000000 / wordCount));
+        Stopwatch watch;
+        for (size_t i = 0; i < loads; i++) {
+            WordLibrary library(1);
+            if (!library.loadFromJSON(path.c_str(), threads)) {
+                throw std::runtime_error("加载合成词库失败");
+            }
+            sink = sink + static_cast<int64_t>(library.size());
+        }
+        results.push_back(watch.finish("loadFromJSON", loads));
+    }
+
+    WordLibrary library(12345);
+    library.loadFromJSON(path.c_str(), threads);
+    std::filesystem::remove(path);
+
+    {
+        Stopwatch watch;
+        int64_t sum = 0;
+        for (size_t i = 0; i < ops; i++) {
+            sum += library.getRandomUnlearnedWord();
+        }
+        sink = sum;
+        results.push_back(watch.finish("getRandomUnlearnedWord", ops));
+    }
+
+    // 准备复习样本：一半单词标为已学，熟悉度 0-2（都参与加权抽样）
+    std::mt19937 gen(7);
+    int64_t now = 1700000000;
+    for (size_t i = 0; i < library.size(); i += 2) {
+        library.updateWordStatus(static_cast<int>(i), static_cast<int>(gen() % 3), now);
+    }
+
+    {
+        Stopwatch watch;
+        int64_t sum = 0;
+        for (size_t i = 0; i < ops; i++) {
+            sum += library.getRandomLearnedWord();
+        }
+        sink = sum;
+        results.push_back(watch.finish("getRandomLearnedWord", ops));
+    }
+
+    {
+        // 预先生成随机序列，计时中只包含 updateWordStatus 本身
+        std::vector<uint32_t> indexes(ops);
+        std::vector<uint8_t> familiarities(ops);
+        std::uniform_int_distribution<uint32_t> pick(0, static_cast<uint32_t>(library.size() - 1));
+        for (size_t i = 0; i < ops; i++) {
+            indexes[i] = pick(gen);
+            familiarities[i] = static_cast<uint8_t>(gen() % 4);
+        }
+
+        Stopwatch watch;
+        for (size_t i = 0; i < ops; i++) {
+            library.updateWordStatus(static_cast<int>(indexes[i]), familiarities[i], now + static_cast<int64_t>(i));
+        }
+        results.push_back(watch.finish("updateWordStatus", ops));
+    }
+
+    {
+        // 查询为词库中的单词改错一个字母，和用户拼错时的情况相近
+        size_t fuzzyOps = std::max<size_t>(100, ops / 1000);
+        std::vector<std::string> queries(fuzzyOps);
+        std::uniform_int_distribution<uint32_t> pick(0, static_cast<uint32_t>(library.size() - 1));
+        for (std::string& query : queries) {
+            query = std::string(library[pick(gen)].word);
+            if (!query.empty()) query[gen() % query.size()] = static_cast<char>('a' + gen() % 26);
+        }
+        std::vector<FuzzyMatch> matches;
+        matches.reserve(library.size());
+
+        Stopwatch watch;
+        int64_t sum = 0;
+        for (const std::string& query : queries) {
+            sum += static_cast<int64_t>(library.searchSimilar(query, 2, 8, matches));
+        }
+        sink = sum;
+        results.push_back(watch.finish("searchSimilar", fuzzyOps));
+    }
+
+    std::fprintf(stderr, "%zu 个单词（%.1f MB）：\n", wordCount, fileBytes / (1024.0 * 1024.0));
+    json benchmarks = json::array();
+    for (const BenchResult& r : results) {
+        report(r);
+        benchmarks.push_back({
+            { "name", r.name },
+            { "ops", r.ops },
+            { "ns_per_op", r.nsPerOp },
+            { "allocations_per_op", r.allocationsPerOp },
+            { "peak_rss_kb", r.peakRssKb },
+        });
+    }
+
+    return {
+        { "words", wordCount },
+        { "json_bytes", fileBytes },
+        { "benchmarks", benchmarks },
+    };
+}
+
+static std::vector<size_t> parseSizes(const char* arg) {
+    std::vector<size_t> sizes;
+    const char* p = arg;
+    while (*p != '\0') {
+        char* end;
+        unsigned long long value = std::strtoull(p, &end, 10);
+        if (end == p) break;
+        if (value > 0) sizes.push_back(static_cast<size_t>(value));
+        p = *end == ',' ? end + 1 : end;
+    }
+    return sizes;
+}
+
+int main(int argc, char* argv[]) {
+    std::vector<size_t> sizes = { 4000, 100000, 1000000 };
+    size_t ops = 1000000;
+    unsigned threads = 0;
+    std::filesystem::path dir = std::filesystem::temp_directory_path();
+
+    for (int i = 1; i < argc; i++) {
+        bool hasValue = i + 1 < argc;
+        if (std::strcmp(argv[i], "--sizes") == 0 && hasValue) {
+            sizes = parseSizes(argv[++i]);
+        }
+        else if (std::strcmp(argv[i], "--ops") == 0 && hasValue) {
+            ops = std::strtoull(argv[++i], nullptr, 10);
+        }
+        else if (std::strcmp(argv[i], "--threads") == 0 && hasValue) {
+            threads = static_cast<unsigned>(std::strtoul(argv[++i], nullptr, 10));
+        }
+        else if (std::strcmp(argv[i], "--dir") == 0 && hasValue) {
+            dir = argv[++i];
+        }
+        else {
+            std::cerr << "用法: vocab_bench [--sizes 4000,100000,1000000] [--ops N] [--threads N] [--dir 路径]" << std::endl;
+            return 2;
+        }
+    }
+    if (sizes.empty() || ops == 0) {
+        std::cerr << "规模和操作次数必须大于 0" << std::endl;
+        return 2;
+    }
+
+    json runs = json::array();
+    try {
+        for (size_t wordCount : sizes) {
+            runs.push_back(runSize(wordCount, ops, threads, dir));
+        }
+    }
+    catch (const std::exception& e) {
+        std::cerr << "基准测试失败: " << e.what() << std::endl;
+        return 1;
+    }
+
+    json output = {
+        { "benchmark", "vocab_bench" },
+        { "threads", threads },
+        { "peak_rss_kb", peakRssKb() },
+        { "runs", runs },
+    };
+    std::cout << output.dump(2) << std::endl;
+    return 0;
+}
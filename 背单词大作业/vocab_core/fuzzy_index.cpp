@@ -0,0 +1,142 @@
+﻿#include "fuzzy_index.h"
+
+#include <algorithm>
+
+// ASCII 字母折叠成小写，其他字节（包括 UTF-8 多字节字符）原样比较
+static inline unsigned char foldCase(char c) {
+    unsigned char u = static_cast<unsigned char>(c);
+    return (u >= 'A' && u <= 'Z') ? static_cast<unsigned char>(u + ('a' - 'A')) : u;
+}
+
+// 字符在集合中的位：26 个字母各占一位，其他字节分到剩下的 6 位
+static inline uint32_t letterBit(unsigned char c) {
+    if (c >= 'a' && c <= 'z') return 1u << (c - 'a');
+    return 1u << (26 + c % 6);
+}
+
+// a 和 b 中置位的个数是否都不超过 k：每次去掉最低的一位，k 次后都为 0 即可。
+// 循环次数只和 k 有关，扫描时没有依赖数据的分支
+static inline bool withinBound(uint32_t a, uint32_t b, int k) {
+    for (int i = 0; i < k; i++) {
+        a &= a - 1;
+        b &= b - 1;
+    }
+    return (a | b) == 0;
+}
+
+// Myers / Hyyrö 位并行编辑距离。peq[c] 的第 i 位表示查询串第 i 个字符是 c，
+// pv/mv 是 DP 表当前列相邻两行之差为 +1/-1 的位置，score 跟踪最后一行的值。
+// 剩下的字符全部匹配也降不到 maxDistance 以内时提前结束，返回 maxDistance + 1
+static int boundedDistance(const uint64_t* peq, size_t m, const char* word, size_t n, int maxDistance) {
+    uint64_t pv = ~0ull;
+    uint64_t mv = 0;
+    uint64_t last = 1ull << (m - 1);
+    int score = static_cast<int>(m);
+
+    for (size_t j = 0; j < n; j++) {
+        uint64_t eq = peq[static_cast<unsigned char>(word[j])];
+        uint64_t xv = eq | mv;
+        uint64_t xh = (((eq & pv) + pv) ^ pv) | eq;
+        uint64_t ph = mv | ~(xh | pv);
+        uint64_t mh = pv & xh;
+        if (ph & last) score++;
+        else if (mh & last) score--;
+        // 第 0 行是 0, 1, 2, ...，每列比前一列大 1
+        ph = (ph << 1) | 1;
+        mh <<= 1;
+        pv = mh | ~(xv | ph);
+        mv = ph & xv;
+
+        if (score - static_cast<int>(n - 1 - j) > maxDistance) return maxDistance + 1;
+    }
+    return score;
+}
+
+void FuzzyIndex::build(const WordStore& source) {
+    size_t count = source.size();
+    size_t maxLength = 0;
+    size_t totalBytes = 0;
+    for (size_t i = 0; i < count; i++) {
+        maxLength = std::max(maxLength, source.word(i).size());
+        totalBytes += source.word(i).size();
+    }
+
+    // 按长度计数排序，同样长度的单词保持下标顺序
+    lengthStart.assign(maxLength + 2, 0);
+    for (size_t i = 0; i < count; i++) {
+        lengthStart[source.word(i).size() + 1]++;
+    }
+    for (size_t length = 1; length < lengthStart.size(); length++) {
+        lengthStart[length] += lengthStart[length - 1];
+    }
+
+    indexes.resize(count);
+    std::vector<uint32_t> next(lengthStart.begin(), lengthStart.end() - 1);
+    for (size_t i = 0; i < count; i++) {
+        indexes[next[source.word(i).size()]++] = static_cast<uint32_t>(i);
+    }
+
+    // 同样长度的单词在 text 中等长排列，位置可以直接算出，不用逐个记录
+    textStart.assign(lengthStart.size(), 0);
+    for (size_t length = 1; length < textStart.size(); length++) {
+        textStart[length] = textStart[length - 1] + (lengthStart[length] - lengthStart[length - 1]) * (length - 1);
+    }
+
+    letters.resize(count);
+    text.clear();
+    text.reserve(totalBytes);
+    for (size_t e = 0; e < count; e++) {
+        uint32_t set = 0;
+        for (char c : source.word(indexes[e])) {
+            unsigned char folded = foldCase(c);
+            text.push_back(static_cast<char>(folded));
+            set |= letterBit(folded);
+        }
+        letters[e] = set;
+    }
+}
+
+size_t FuzzyIndex::search(std::string_view query, int maxDistance, size_t maxResults, std::vector<FuzzyMatch>& results) const {
+    results.clear();
+    size_t m = query.size();
+    if (m == 0 || m > MAX_QUERY_LENGTH || maxDistance < 0 || indexes.empty()) return 0;
+
+    uint64_t peq[256] = {};
+    uint32_t queryLetters = 0;
+    for (size_t i = 0; i < m; i++) {
+        unsigned char c = foldCase(query[i]);
+        peq[c] |= 1ull << i;
+        queryLetters |= letterBit(c);
+    }
+
+    // 长度相差超过 k 的单词不可能在距离 k 以内
+    size_t k = static_cast<size_t>(maxDistance);
+    size_t minLength = m > k ? m - k : 0;
+    size_t maxLength = std::min(m + k, lengthStart.size() - 2);
+    for (size_t length = minLength; length <= maxLength; length++) {
+        const char* words = text.data() + textStart[length];
+        uint32_t first = lengthStart[length];
+        for (uint32_t e = first; e < lengthStart[length + 1]; e++) {
+            // 查询中有而单词中没有的每种字符至少要删除或替换一次，反过来至少要插入或替换一次
+            if (!withinBound(queryLetters & ~letters[e], letters[e] & ~queryLetters, maxDistance)) continue;
+
+            int distance = boundedDistance(peq, m, words + (e - first) * length, length, maxDistance);
+            if (distance <= maxDistance) {
+                results.push_back({ static_cast<int>(indexes[e]), distance });
+            }
+        }
+    }
+
+    size_t total = results.size();
+    auto closer = [](const FuzzyMatch& a, const FuzzyMatch& b) {
+        return a.distance < b.distance || (a.distance == b.distance && a.index < b.index);
+    };
+    if (total > maxResults) {
+        std::partial_sort(results.begin(), results.begin() + maxResults, results.end(), closer);
+        results.resize(maxResults);
+    }
+    else {
+        std::sort(results.begin(), results.end(), closer);
+    }
+    return total;
+}
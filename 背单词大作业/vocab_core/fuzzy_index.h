@@ -0,0 +1,48 @@
+﻿#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <string_view>
+#include <vector>
+
+#include "word_store.h"
+
+// 拼写相近的查找结果
+struct FuzzyMatch {
+    int index;    // 单词下标
+    int distance; // 与查询的编辑距离
+};
+
+// 拼写索引：查找与给定字符串的编辑距离（Levenshtein）不超过 k 的单词，用于"你是不是要找"。
+// 单词折叠成小写后按长度分组连续存放，查询时只看长度相差不超过 k 的几组；
+// 每个单词再用字符集合的差算出距离的下界，下界超过 k 的直接跳过，
+// 剩下的用 Myers 位并行算法计算距离，查询串每个字节占 64 位字中的一位，每个字符 O(1)。
+class FuzzyIndex {
+private:
+    // 以下三个数组都按单词长度排序，同样长度的按下标排列。
+    // 长度为 L 的单词是第 lengthStart[L] 到 lengthStart[L + 1] - 1 个，每个在 text 中占 L 字节
+    std::vector<uint32_t> letters;     // 单词中出现的字符集合，见 fuzzy_index.cpp 中的 letterBit
+    std::vector<uint32_t> indexes;     // 单词下标
+    std::vector<char> text;            // 折叠成小写的单词，按上面的顺序连续存放
+    std::vector<size_t> textStart;     // 长度为 L 的第一个单词在 text 中的位置
+    std::vector<uint32_t> lengthStart;
+
+public:
+    // 查询串的最大长度（位并行算法中一个 64 位字的位数）
+    static const size_t MAX_QUERY_LENGTH = 64;
+
+    // 为 source 中的全部单词建立索引，O(n)
+    void build(const WordStore& source);
+
+    size_t size() const { return indexes.size(); }
+
+    // 查找与 query 的编辑距离不超过 maxDistance 的单词（只把 ASCII 字母折叠成小写比较），
+    // 按距离从小到大、距离相同时按下标排列，最多取 maxResults 个放入 results，返回匹配的总数。
+    // query 为空或长于 MAX_QUERY_LENGTH 时返回 0
+    size_t search(std::string_view query, int maxDistance, size_t maxResults, std::vector<FuzzyMatch>& results) const;
+
+    size_t memoryBytes() const {
+        return (letters.capacity() + indexes.capacity() + lengthStart.capacity()) * sizeof(uint32_t) +
+            text.capacity() + textStart.capacity() * sizeof(size_t);
+    }
+};
@@ -0,0 +1,289 @@
+﻿#include "meaning_index.h"
+
+#include <algorithm>
+#include <fstream>
+
+#include "json.hpp"
+#include "word_library.h"
+
+using json = nlohmann::json;
+
+const uint64_t BIGRAM_FLAG = 1ull << 42;
+
+// 从 UTF-8 字符串中取下一个码点，非法字节按单个字节跳过（返回 0）
+static uint32_t nextCodePoint(std::string_view text, size_t& pos) {
+    unsigned char c = static_cast<unsigned char>(text[pos]);
+    int length = c < 0x80 ? 1 : (c >> 5) == 0x06 ? 2 : (c >> 4) == 0x0E ? 3 : (c >> 3) == 0x1E ? 4 : 0;
+    if (length == 0 || pos + length > text.size()) {
+        pos++;
+        return 0;
+    }
+    uint32_t cp = length == 1 ? c : c & (0x7F >> length);
+    for (int i = 1; i < length; i++) {
+        cp = (cp << 6) | (static_cast<unsigned char>(text[pos + i]) & 0x3F);
+    }
+    pos += length;
+    return cp;
+}
+
+// 中日韩统一表意文字（基本区、扩展 A 区、兼容区和扩展 B 区以后）
+static bool isHan(uint32_t cp) {
+    return (cp >= 0x4E00 && cp <= 0x9FFF) || (cp >= 0x3400 && cp <= 0x4DBF) ||
+        (cp >= 0xF900 && cp <= 0xFAFF) || (cp >= 0x20000 && cp <= 0x2FFFF);
+}
+
+// 取出文本中的全部单字和双字；双字只由相邻的两个汉字组成，被其他字符隔开的不算
+template <typename Callback>
+static void forEachTerm(std::string_view text, bool unigrams, bool bigrams, Callback callback) {
+    uint32_t previous = 0;
+    size_t pos = 0;
+    while (pos < text.size()) {
+        uint32_t cp = nextCodePoint(text, pos);
+        if (!isHan(cp)) {
+            previous = 0;
+            continue;
+        }
+        if (unigrams) callback(static_cast<uint64_t>(cp));
+        if (bigrams && previous != 0) callback(BIGRAM_FLAG | (static_cast<uint64_t>(previous) << 21) | cp);
+        previous = cp;
+    }
+}
+
+static void appendVarint(std::vector<uint8_t>& out, uint32_t value) {
+    while (value >= 0x80) {
+        out.push_back(static_cast<uint8_t>(value | 0x80));
+        value >>= 7;
+    }
+    out.push_back(static_cast<uint8_t>(value));
+}
+
+// 顺序解码一个列表
+class PostingReader {
+private:
+    const uint8_t* pos;
+    uint32_t remaining;
+    uint32_t current;
+
+public:
+    PostingReader(const uint8_t* data, uint32_t count) : pos(data), remaining(count), current(0) {}
+
+    bool next(uint32_t& value) {
+        if (remaining == 0) return false;
+        uint32_t delta = 0;
+        int shift = 0;
+        uint8_t byte;
+        do {
+            byte = *pos++;
+            delta |= static_cast<uint32_t>(byte & 0x7F) << shift;
+            shift += 7;
+        } while (byte & 0x80);
+        current += delta;
+        remaining--;
+        value = current;
+        return true;
+    }
+};
+
+// 从一个单词对象中收集 translations 里的全部 translation 字符串。
+// 层级约定: 1-单词对象, 2-translations 数组, 3-translation 对象
+class TranslationCollector : public json::json_sax_t {
+private:
+    int depth;
+    bool inTranslations;    // 单词对象中当前键是否为 "translations"
+    bool inTranslationText; // translation 对象中当前键是否为 "translation"
+
+public:
+    std::vector<std::string> translations;
+
+    TranslationCollector() : depth(0), inTranslations(false), inTranslationText(false) {}
+
+    bool null() override { return true; }
+    bool boolean(bool) override { return true; }
+    bool number_integer(number_integer_t) override { return true; }
+    bool number_unsigned(number_unsigned_t) override { return true; }
+    bool number_float(number_float_t, const string_t&) override { return true; }
+    bool binary(binary_t&) override { return true; }
+
+    bool string(string_t& val) override {
+        if (depth == 3 && inTranslations && inTranslationText) {
+            translations.push_back(std::move(val));
+        }
+        return true;
+    }
+
+    bool start_object(std::size_t) override {
+        depth++;
+        if (depth == 3) inTranslationText = false;
+        return true;
+    }
+
+    bool key(string_t& val) override {
+        if (depth == 1) inTranslations = (val == "translations");
+        else if (depth == 3) inTranslationText = (val == "translation");
+        return true;
+    }
+
+    bool end_object() override {
+        depth--;
+        return true;
+    }
+
+    bool start_array(std::size_t) override {
+        depth++;
+        return true;
+    }
+
+    bool end_array() override {
+        depth--;
+        return true;
+    }
+
+    bool parse_error(std::size_t, const std::string&, const nlohmann::detail::exception&) override {
+        return false;
+    }
+};
+
+void MeaningIndex::build(const WordLibrary& library, const char* sourcePath) {
+    terms.clear();
+    postings.clear();
+    postingCount = 0;
+
+    // 源文件与单词库一致时整个读入，按位置表取出每个单词对象
+    std::vector<char> source;
+    if (sourcePath != nullptr && library.sourceSize() > 0) {
+        uint64_t size;
+        int64_t time;
+        if (getFileStamp(sourcePath, size, time) && size == library.sourceSize()) {
+            std::ifstream file(sourcePath, std::ios::binary);
+            source.resize(static_cast<size_t>(size));
+            if (!file.read(source.data(), static_cast<std::streamsize>(source.size()))) {
+                source.clear();
+            }
+        }
+    }
+
+    // 收集 (字词, 单词下标) 对，排序去重后按字词分组编码
+    std::vector<std::pair<uint64_t, uint32_t>> pairs;
+    pairs.reserve(library.size() * 8);
+    std::vector<uint64_t> wordTerms;
+    for (size_t i = 0; i < library.size(); i++) {
+        wordTerms.clear();
+        auto collect = [&wordTerms](uint64_t term) { wordTerms.push_back(term); };
+        forEachTerm(library.wordTable().meaning(i), true, true, collect);
+
+        uint64_t offset;
+        uint32_t length;
+        if (!source.empty() && library.sourceRange(i, offset, length) && offset + length <= source.size()) {
+            TranslationCollector collector;
+            const char* begin = source.data() + offset;
+            json::sax_parse(begin, begin + length, &collector);
+            for (const std::string& translation : collector.translations) {
+                forEachTerm(translation, true, true, collect);
+            }
+        }
+
+        std::sort(wordTerms.begin(), wordTerms.end());
+        wordTerms.erase(std::unique(wordTerms.begin(), wordTerms.end()), wordTerms.end());
+        for (uint64_t term : wordTerms) {
+            pairs.emplace_back(term, static_cast<uint32_t>(i));
+        }
+    }
+    std::sort(pairs.begin(), pairs.end());
+
+    // 同一字词的下标已经升序，存与前一个下标的差值
+    postings.reserve(pairs.size() * 2);
+    for (size_t i = 0; i < pairs.size();) {
+        Term t;
+        t.term = pairs[i].first;
+        t.offset = static_cast<uint32_t>(postings.size());
+        t.count = 0;
+        uint32_t previous = 0;
+        for (; i < pairs.size() && pairs[i].first == t.term; i++) {
+            appendVarint(postings, pairs[i].second - previous);
+            previous = pairs[i].second;
+            t.count++;
+        }
+        terms.push_back(t);
+    }
+    postingCount = pairs.size();
+    terms.shrink_to_fit();
+    postings.shrink_to_fit();
+}
+
+const MeaningIndex::Term* MeaningIndex::findTerm(uint64_t term) const {
+    auto it = std::lower_bound(terms.begin(), terms.end(), term,
+        [](const Term& t, uint64_t key) { return t.term < key; });
+    return it != terms.end() && it->term == term ? &*it : nullptr;
+}
+
+bool MeaningIndex::queryTerms(std::string_view query, std::vector<const Term*>& result) const {
+    result.clear();
+    // 连续的汉字按双字查找；前后都不是汉字的单个汉字按单字查找
+    std::vector<uint32_t> run;
+    bool found = true;
+    auto flush = [&]() {
+        if (run.size() == 1) {
+            const Term* t = findTerm(run[0]);
+            if (t == nullptr) found = false;
+            else result.push_back(t);
+        }
+        for (size_t i = 1; i < run.size(); i++) {
+            const Term* t = findTerm(BIGRAM_FLAG | (static_cast<uint64_t>(run[i - 1]) << 21) | run[i]);
+            if (t == nullptr) found = false;
+            else result.push_back(t);
+        }
+        run.clear();
+    };
+
+    size_t pos = 0;
+    while (pos < query.size()) {
+        uint32_t cp = nextCodePoint(query, pos);
+        if (isHan(cp)) run.push_back(cp);
+        else flush();
+    }
+    flush();
+    return found && !result.empty();
+}
+
+size_t MeaningIndex::search(std::string_view query, size_t maxResults, std::vector<int>& results) const {
+    results.clear();
+    std::vector<const Term*> lists;
+    if (!queryTerms(query, lists)) {
+        return 0;
+    }
+
+    // 从最短的列表开始，逐个与其余列表求交，候选只会越来越少
+    std::sort(lists.begin(), lists.end(), [](const Term* a, const Term* b) { return a->count < b->count; });
+    std::vector<uint32_t> candidates;
+    candidates.reserve(lists[0]->count);
+    PostingReader first(postings.data() + lists[0]->offset, lists[0]->count);
+    uint32_t value;
+    while (first.next(value)) {
+        candidates.push_back(value);
+    }
+
+    for (size_t k = 1; k < lists.size() && !candidates.empty(); k++) {
+        PostingReader reader(postings.data() + lists[k]->offset, lists[k]->count);
+        size_t kept = 0;
+        size_t i = 0;
+        bool hasValue = reader.next(value);
+        while (i < candidates.size() && hasValue) {
+            if (candidates[i] < value) {
+                i++;
+            }
+            else if (value < candidates[i]) {
+                hasValue = reader.next(value);
+            }
+            else {
+                candidates[kept++] = candidates[i++];
+                hasValue = reader.next(value);
+            }
+        }
+        candidates.resize(kept);
+    }
+
+    for (size_t i = 0; i < candidates.size() && results.size() < maxResults; i++) {
+        results.push_back(static_cast<int>(candidates[i]));
+    }
+    return candidates.size();
+}
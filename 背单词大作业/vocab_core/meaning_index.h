@@ -0,0 +1,47 @@
+﻿#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <string_view>
+#include <vector>
+
+class WordLibrary;
+
+// 释义倒排索引（中译英查找）：释义中的每个汉字（单字）和相邻的两个汉字（双字）
+// 对应一个包含它的单词下标列表。列表升序排列，存相邻下标的差值并用变长整数编码，
+// 全部列表连续存放在一块缓冲区中。
+// 查询时取查询词中的全部双字（单独一个汉字时用单字），对它们的列表求交集，不扫描单词库。
+class MeaningIndex {
+private:
+    struct Term {
+        uint64_t term;    // 单字为码点，双字为 (1 << 42) | (第一个字 << 21) | 第二个字
+        uint32_t offset;  // 列表在 postings 中的起始字节
+        uint32_t count;   // 列表中的单词数
+    };
+
+    std::vector<Term> terms;        // 按 term 排序
+    std::vector<uint8_t> postings;  // 全部列表
+    size_t postingCount;            // 列表中的下标总数
+
+    const Term* findTerm(uint64_t term) const;
+
+    // 把查询词拆成要求交的字词，含有不在索引中的字词时返回 false
+    bool queryTerms(std::string_view query, std::vector<const Term*>& result) const;
+
+public:
+    MeaningIndex() : postingCount(0) {}
+
+    // 从单词库的释义建立索引。sourcePath 不为空且与单词库的源文件一致时，
+    // 再按快照中记录的位置读出 words.json 里每个单词的全部释义一起索引
+    void build(const WordLibrary& library, const char* sourcePath = nullptr);
+
+    // 查找释义中包含 query 的单词（按下标顺序），最多取 maxResults 个放入 results，返回匹配的总数。
+    // query 中的非汉字字符被忽略
+    size_t search(std::string_view query, size_t maxResults, std::vector<int>& results) const;
+
+    bool empty() const { return terms.empty(); }
+    size_t termCount() const { return terms.size(); }
+    size_t postingTotal() const { return postingCount; }
+    size_t postingBytes() const { return postings.size(); }
+    size_t memoryBytes() const { return terms.capacity() * sizeof(Term) + postings.capacity(); }
+};
@@ -0,0 +1,78 @@
+﻿#include "prefix_index.h"
+
+#include <algorithm>
+
+// ASCII 字母折叠成小写，其他字节（包括 UTF-8 多字节字符）原样比较
+static inline unsigned char foldCase(char c) {
+    unsigned char u = static_cast<unsigned char>(c);
+    return (u >= 'A' && u <= 'Z') ? static_cast<unsigned char>(u + ('a' - 'A')) : u;
+}
+
+// 折叠大小写后按字节比较，返回负数、0 或正数
+static int compareFolded(std::string_view a, std::string_view b) {
+    size_t n = std::min(a.size(), b.size());
+    for (size_t i = 0; i < n; i++) {
+        unsigned char x = foldCase(a[i]);
+        unsigned char y = foldCase(b[i]);
+        if (x != y) return x < y ? -1 : 1;
+    }
+    if (a.size() == b.size()) return 0;
+    return a.size() < b.size() ? -1 : 1;
+}
+
+void PrefixIndex::build(const WordStore& source) {
+    store = &source;
+    order.resize(source.size());
+    for (size_t i = 0; i < order.size(); i++) {
+        order[i] = static_cast<uint32_t>(i);
+    }
+
+    // 相同的单词按下标排列，结果与排序算法无关
+    auto less = [&source](uint32_t a, uint32_t b) {
+        int c = compareFolded(source.word(a), source.word(b));
+        return c < 0 || (c == 0 && a < b);
+    };
+    if (!std::is_sorted(order.begin(), order.end(), less)) {
+        std::sort(order.begin(), order.end(), less);
+    }
+}
+
+void PrefixIndex::range(std::string_view prefix, size_t& first, size_t& last) const {
+    const WordStore& source = *store;
+    // 第一个不小于 prefix 的单词
+    auto begin = std::lower_bound(order.begin(), order.end(), prefix,
+        [&source](uint32_t index, std::string_view key) {
+            return compareFolded(source.word(index), key) < 0;
+        });
+    // 截到 prefix 的长度后仍大于 prefix 的第一个单词，即不以 prefix 开头的第一个单词
+    auto end = std::upper_bound(begin, order.end(), prefix,
+        [&source](std::string_view key, uint32_t index) {
+            return compareFolded(key, source.word(index).substr(0, key.size())) < 0;
+        });
+    first = static_cast<size_t>(begin - order.begin());
+    last = static_cast<size_t>(end - order.begin());
+}
+
+size_t PrefixIndex::search(std::string_view prefix, size_t maxResults, std::vector<int>& results) const {
+    results.clear();
+    if (store == nullptr) return 0;
+
+    size_t first, last;
+    range(prefix, first, last);
+    for (size_t i = first; i < last && results.size() < maxResults; i++) {
+        results.push_back(static_cast<int>(order[i]));
+    }
+    return last - first;
+}
+
+int PrefixIndex::find(std::string_view word) const {
+    if (store == nullptr) return -1;
+
+    size_t first, last;
+    range(word, first, last);
+    // 以 word 开头的单词中，与 word 等长的排在最前面
+    if (first < last && store->word(order[first]).size() == word.size()) {
+        return static_cast<int>(order[first]);
+    }
+    return -1;
+}
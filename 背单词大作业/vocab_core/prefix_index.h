@@ -0,0 +1,39 @@
+﻿#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <string_view>
+#include <vector>
+
+#include "word_store.h"
+
+// 前缀索引：单词下标按单词排序（只把 ASCII 字母折叠成小写比较）保存在一个数组里，
+// 以某个前缀开头的单词在数组中是连续的一段，用两次二分查找定位，O(log n)。
+// 每个单词只占 4 字节，字符串仍然留在 WordStore 中。
+class PrefixIndex {
+private:
+    const WordStore* store;
+    std::vector<uint32_t> order; // 排好序的单词下标
+
+public:
+    PrefixIndex() : store(nullptr) {}
+
+    // 为 source 中的全部单词建立索引。词库本来就按字母顺序排列时只需一次线性检查
+    void build(const WordStore& source);
+
+    size_t size() const { return order.size(); }
+
+    // 以 prefix 开头的单词在排序数组中的范围 [first, last)
+    void range(std::string_view prefix, size_t& first, size_t& last) const;
+
+    // 排序数组中第 position 个单词的下标
+    int wordAt(size_t position) const { return static_cast<int>(order[position]); }
+
+    // 取以 prefix 开头的前 maxResults 个单词（按字母顺序）放入 results，返回匹配的总数
+    size_t search(std::string_view prefix, size_t maxResults, std::vector<int>& results) const;
+
+    // 按单词精确查找（不区分大小写），找不到时返回 -1
+    int find(std::string_view word) const;
+
+    size_t memoryBytes() const { return order.capacity() * sizeof(uint32_t); }
+};
@@ -0,0 +1,262 @@
+﻿#include "review_journal.h"
+
+#include <chrono>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+
+#ifdef _WIN32
+#include <io.h>
+#else
+#include <unistd.h>
+#endif
+
+const char JOURNAL_MAGIC[4] = { 'W', 'L', 'J', 'R' };
+const char PROGRESS_MAGIC[4] = { 'W', 'L', 'P', 'S' };
+const uint32_t JOURNAL_VERSION = 1;
+const uint32_t PROGRESS_VERSION = 2;                                   // 2: 快照中追加了复习计划
+const uint32_t PROGRESS_VERSION_FAMILIARITY_ONLY = 1;                  // 1: 只有熟悉度的旧快照
+const size_t JOURNAL_BATCH_SIZE = 64;                                  // 攒够多少条立即写盘
+const std::chrono::milliseconds JOURNAL_FLUSH_INTERVAL(500);           // 最长等待多久写盘
+const uint64_t JOURNAL_COMPACT_THRESHOLD = 16384;                      // 日志超过多少条时压缩
+
+// 把缓冲区写入磁盘
+static void syncFile(FILE* file) {
+    fflush(file);
+#ifdef _WIN32
+    _commit(_fileno(file));
+#else
+    fsync(fileno(file));
+#endif
+}
+
+void ProgressState::apply(const JournalRecord& record) {
+    familiarity[record.wordIndex] = static_cast<uint8_t>(record.familiarity);
+    applyReview(schedules[record.wordIndex], static_cast<int>(record.familiarity), record.timestamp);
+}
+
+ProgressFileHeader ReviewJournal::makeHeader(const char* magic, uint32_t version) const {
+    ProgressFileHeader h = header;
+    std::memcpy(h.magic, magic, sizeof(h.magic));
+    h.version = version;
+    return h;
+}
+
+// 只比较 magic、单词数和哈希，版本号由调用者检查
+bool ReviewJournal::headerMatches(const ProgressFileHeader& h, const char* magic) const {
+    return std::memcmp(h.magic, magic, sizeof(h.magic)) == 0 &&
+        h.wordCount == header.wordCount &&
+        h.libraryHash == header.libraryHash;
+}
+
+void ReviewJournal::readSnapshot() {
+    std::ifstream in(snapshotPath, std::ios::binary);
+    if (!in.is_open()) return;
+
+    ProgressFileHeader h;
+    std::vector<uint8_t> values(header.wordCount);
+    std::vector<CardSchedule> schedules(header.wordCount);
+    bool valid = in.read(reinterpret_cast<char*>(&h), sizeof(h)) && headerMatches(h, PROGRESS_MAGIC) &&
+        (h.version == PROGRESS_VERSION || h.version == PROGRESS_VERSION_FAMILIARITY_ONLY) &&
+        in.read(reinterpret_cast<char*>(values.data()), values.size());
+    if (valid && h.version == PROGRESS_VERSION) {
+        valid = static_cast<bool>(in.read(reinterpret_cast<char*>(schedules.data()),
+            schedules.size() * sizeof(CardSchedule)));
+    }
+    if (!valid) {
+        std::cerr << "学习进度快照无效，已忽略: " << snapshotPath << std::endl;
+        return;
+    }
+    snapshotGeneration = h.generation;
+
+    // 旧版快照没有复习计划，这些单词视为立即到期
+    for (size_t i = 0; i < values.size(); i++) {
+        if (values[i] <= 3) {
+            state.familiarity[i] = values[i];
+            state.schedules[i] = schedules[i];
+        }
+    }
+}
+
+bool ReviewJournal::replayJournal() {
+    std::ifstream in(journalPath, std::ios::binary | std::ios::ate);
+    if (!in.is_open()) return false;
+
+    std::streamoff fileSize = in.tellg();
+    in.seekg(0);
+    ProgressFileHeader h;
+    if (fileSize < static_cast<std::streamoff>(sizeof(h)) ||
+        !in.read(reinterpret_cast<char*>(&h), sizeof(h)) || !headerMatches(h, JOURNAL_MAGIC) ||
+        h.version != JOURNAL_VERSION) {
+        // 属于其他词库或已损坏的日志：保留备份，重新开始
+        in.close();
+        std::error_code ec;
+        std::filesystem::rename(journalPath, journalPath + ".bak", ec);
+        std::cerr << "学习进度日志与当前词库不匹配，已备份为 " << journalPath << ".bak" << std::endl;
+        return false;
+    }
+
+    // 快照之后、换新日志之前退出时留下的旧日志：记录已经包含在快照中，不能再重放一次
+    if (snapshotGeneration != 0 && h.generation <= snapshotGeneration) {
+        return false;
+    }
+    generation = h.generation;
+
+    size_t recordCount = static_cast<size_t>(fileSize - sizeof(h)) / sizeof(JournalRecord);
+    std::vector<JournalRecord> records(recordCount);
+    in.read(reinterpret_cast<char*>(records.data()), recordCount * sizeof(JournalRecord));
+    for (const JournalRecord& r : records) {
+        if (r.wordIndex < state.familiarity.size() && r.familiarity <= 3) {
+            state.apply(r);
+        }
+    }
+    journalRecords = recordCount;
+    in.close();
+
+    // 上次退出时写了一半的记录直接截掉，保证之后追加的记录对齐
+    uint64_t validSize = sizeof(h) + recordCount * sizeof(JournalRecord);
+    if (static_cast<uint64_t>(fileSize) != validSize) {
+        std::error_code ec;
+        std::filesystem::resize_file(journalPath, validSize, ec);
+    }
+    return true;
+}
+
+bool ReviewJournal::createJournal() {
+    file = fopen(journalPath.c_str(), "wb");
+    if (file == nullptr) return false;
+    generation = snapshotGeneration + 1;
+    ProgressFileHeader h = makeHeader(JOURNAL_MAGIC, JOURNAL_VERSION);
+    h.generation = generation;
+    fwrite(&h, sizeof(h), 1, file);
+    syncFile(file);
+    journalRecords = 0;
+    return true;
+}
+
+void ReviewJournal::compact() {
+    std::string tmpPath = snapshotPath + ".tmp";
+    FILE* out = fopen(tmpPath.c_str(), "wb");
+    if (out == nullptr) return;
+    // 旧版日志没有代数（0），快照记为第 1 代，旧日志同样会被识别为已包含
+    uint32_t includedGeneration = generation != 0 ? generation : 1;
+    ProgressFileHeader h = makeHeader(PROGRESS_MAGIC, PROGRESS_VERSION);
+    h.generation = includedGeneration;
+    bool ok = fwrite(&h, sizeof(h), 1, out) == 1 &&
+        fwrite(state.familiarity.data(), 1, state.familiarity.size(), out) == state.familiarity.size() &&
+        fwrite(state.schedules.data(), sizeof(CardSchedule), state.schedules.size(), out) == state.schedules.size();
+    syncFile(out);
+    fclose(out);
+
+    std::error_code ec;
+    if (ok) std::filesystem::rename(tmpPath, snapshotPath, ec);
+    if (!ok || ec) {
+        std::filesystem::remove(tmpPath, ec);
+        return;
+    }
+
+    // 快照已落盘并记下了当前日志的代数。即使换新日志前退出，下次启动时
+    // 也会认出旧日志已包含在快照中而跳过它，不会把这些评分重放两次
+    snapshotGeneration = includedGeneration;
+    fclose(file);
+    file = nullptr;
+    createJournal();
+}
+
+void ReviewJournal::writerLoop() {
+    std::vector<JournalRecord> batch;
+    std::unique_lock<std::mutex> lock(mutex);
+    while (true) {
+        wakeUp.wait_for(lock, JOURNAL_FLUSH_INTERVAL, [this] {
+            return stopping || pending.size() >= JOURNAL_BATCH_SIZE;
+        });
+        if (pending.empty()) {
+            if (stopping) break;
+            continue;
+        }
+
+        batch.swap(pending);
+        lock.unlock();
+
+        if (file != nullptr) {
+            fwrite(batch.data(), sizeof(JournalRecord), batch.size(), file);
+            syncFile(file);
+            journalRecords += batch.size();
+        }
+        for (const JournalRecord& r : batch) {
+            state.apply(r);
+        }
+        batch.clear();
+
+        if (file != nullptr && journalRecords >= JOURNAL_COMPACT_THRESHOLD) {
+            compact();
+        }
+
+        lock.lock();
+    }
+}
+
+bool ReviewJournal::open(const char* journalFile, const char* snapshotFile, uint64_t libraryHash,
+    ProgressState& progress) {
+    close();
+    journalPath = journalFile;
+    snapshotPath = snapshotFile;
+    std::memset(&header, 0, sizeof(header));
+    generation = 0;
+    snapshotGeneration = 0;
+    header.wordCount = static_cast<uint32_t>(progress.familiarity.size());
+    header.libraryHash = libraryHash;
+
+    state = progress;
+    state.schedules.resize(state.familiarity.size());
+    readSnapshot();
+    if (replayJournal()) {
+        file = fopen(journalPath.c_str(), "ab");
+    }
+    else {
+        createJournal();
+    }
+    if (file == nullptr) {
+        std::cerr << "无法写入学习进度日志: " << journalPath << std::endl;
+        return false;
+    }
+    progress = state;
+
+    stopping = false;
+    writer = std::thread(&ReviewJournal::writerLoop, this);
+    return true;
+}
+
+void ReviewJournal::append(int wordIndex, int newFamiliarity, int64_t timestamp) {
+    if (!writer.joinable() || wordIndex < 0 || wordIndex >= static_cast<int>(header.wordCount)) {
+        return;
+    }
+    JournalRecord record;
+    record.wordIndex = static_cast<uint32_t>(wordIndex);
+    record.familiarity = static_cast<uint32_t>(newFamiliarity);
+    record.timestamp = timestamp;
+
+    bool wake;
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        pending.push_back(record);
+        wake = pending.size() >= JOURNAL_BATCH_SIZE;
+    }
+    if (wake) wakeUp.notify_one();
+}
+
+void ReviewJournal::close() {
+    if (writer.joinable()) {
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            stopping = true;
+        }
+        wakeUp.notify_one();
+        writer.join();
+    }
+    if (file != nullptr) {
+        fclose(file);
+        file = nullptr;
+    }
+}
@@ -0,0 +1,104 @@
+﻿#pragma once
+
+#include <condition_variable>
+#include <cstdint>
+#include <cstdio>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "review_scheduler.h"
+
+// ---------------- 学习进度日志 ----------------
+// 每次评分追加一条 (单词下标, 新熟悉度, 时间戳) 记录到日志文件。
+// 复习计划完全由评分序列决定，重放时按记录的时间戳重新计算即可。
+// 写盘由后台线程完成：界面线程只把记录放进队列，后台线程攒够一批或
+// 等待超时后统一写入并刷盘。日志过长时把全部熟悉度压缩成进度快照，
+// 然后换一个新日志。启动时先读快照，再按顺序重放日志。
+// 重放不是幂等的（复习计划会重复累加），所以每个日志带一个代数，快照记下
+// 已经包含到哪一代，重放时跳过已包含在快照中的日志。
+
+// 日志文件和进度快照共用的文件头，用单词数和单词哈希确认属于同一个词库
+struct ProgressFileHeader {
+    char magic[4];
+    uint32_t version;
+    uint32_t wordCount;
+    uint32_t generation;      // 日志：第几代；快照：已包含到第几代日志（0 表示没有记录的旧文件）
+    uint64_t libraryHash;
+};
+
+struct JournalRecord {
+    uint32_t wordIndex;
+    uint32_t familiarity;
+    int64_t timestamp;        // 评分时间（Unix 秒）
+};
+
+static_assert(sizeof(ProgressFileHeader) == 24, "进度文件头布局不可改变");
+static_assert(sizeof(JournalRecord) == 16, "日志记录布局不可改变");
+
+// 学习进度：每个单词的熟悉度和复习计划
+struct ProgressState {
+    std::vector<uint8_t> familiarity;
+    std::vector<CardSchedule> schedules;
+
+    // 按顺序应用一条评分记录
+    void apply(const JournalRecord& record);
+};
+
+class ReviewJournal {
+private:
+    std::string journalPath;
+    std::string snapshotPath;
+    ProgressFileHeader header;
+    FILE* file;
+    uint32_t generation;              // 当前日志的代数
+    uint32_t snapshotGeneration;      // 进度快照已包含到第几代日志
+
+    // 以下成员只由后台线程访问
+    ProgressState state;              // 与日志同步的进度副本，用于压缩
+    uint64_t journalRecords;          // 日志中现有的记录数
+
+    std::thread writer;
+    std::mutex mutex;
+    std::condition_variable wakeUp;
+    std::vector<JournalRecord> pending; // 等待写盘的记录
+    bool stopping;
+
+    ProgressFileHeader makeHeader(const char* magic, uint32_t version) const;
+    bool headerMatches(const ProgressFileHeader& h, const char* magic) const;
+
+    // 读取进度快照到 state
+    void readSnapshot();
+
+    // 按顺序重放日志；返回日志是否可以继续追加
+    bool replayJournal();
+
+    // 新建只含文件头的空日志，代数接在快照之后
+    bool createJournal();
+
+    // 把进度副本写成快照，然后换一个新日志（在后台线程执行）
+    void compact();
+
+    void writerLoop();
+
+public:
+    ReviewJournal() : header(), file(nullptr), generation(0), snapshotGeneration(0), journalRecords(0), stopping(false) {}
+
+    ~ReviewJournal() { close(); }
+
+    ReviewJournal(const ReviewJournal&) = delete;
+    ReviewJournal& operator=(const ReviewJournal&) = delete;
+
+    // 读取快照并重放日志，结果写回 progress（传入时为词库自带的熟悉度和空的复习计划），
+    // 然后启动后台写盘线程
+    bool open(const char* journalFile, const char* snapshotFile, uint64_t libraryHash,
+        ProgressState& progress);
+
+    // 记录一次评分（界面线程调用，只入队不写盘）；timestamp 必须与
+    // 计算复习计划时使用的时间一致，重放时才能得到相同的结果
+    void append(int wordIndex, int newFamiliarity, int64_t timestamp);
+
+    // 写完剩余记录并停止后台线程
+    void close();
+};
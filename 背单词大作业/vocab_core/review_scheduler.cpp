@@ -0,0 +1,166 @@
+﻿#include "review_scheduler.h"
+
+#include <utility>
+
+const int64_t SECONDS_PER_DAY = 24 * 60 * 60;
+const int INITIAL_EASE = 2500;
+const int MINIMUM_EASE = 1300;
+const uint32_t MAXIMUM_INTERVAL = 36500; // 间隔上限 100 年，防止溢出
+
+int ratingQuality(int familiarity) {
+    static const int QUALITY[4] = { 0, 3, 4, 5 };
+    if (familiarity < 0) familiarity = 0;
+    if (familiarity > 3) familiarity = 3;
+    return QUALITY[familiarity];
+}
+
+void applyReview(CardSchedule& card, int familiarity, int64_t now) {
+    int q = ratingQuality(familiarity);
+    int ease = card.ease == 0 ? INITIAL_EASE : card.ease;
+
+    if (q < 3) {
+        // 没记住：从头开始，第二天再复习
+        card.repetitions = 0;
+        card.interval = 1;
+    }
+    else {
+        if (card.repetitions == 0) {
+            card.interval = 1;
+        }
+        else if (card.repetitions == 1) {
+            card.interval = 6;
+        }
+        else {
+            uint64_t next = (static_cast<uint64_t>(card.interval) * ease + 500) / 1000;
+            card.interval = static_cast<uint32_t>(next < MAXIMUM_INTERVAL ? next : MAXIMUM_INTERVAL);
+        }
+        if (card.repetitions < UINT16_MAX) card.repetitions++;
+    }
+
+    // EF' = EF + 0.1 - (5 - q) × (0.08 + (5 - q) × 0.02)，这里按千分之一计算
+    int miss = 5 - q;
+    ease += 100 - miss * (80 + miss * 20);
+    card.ease = static_cast<uint16_t>(ease < MINIMUM_EASE ? MINIMUM_EASE : ease);
+
+    card.due = now + static_cast<int64_t>(card.interval) * SECONDS_PER_DAY;
+}
+
+void ReviewScheduler::swapNodes(int a, int b) {
+    std::swap(heap[a], heap[b]);
+    positions[heap[a]] = a;
+    positions[heap[b]] = b;
+}
+
+void ReviewScheduler::siftUp(int pos) {
+    while (pos > 0) {
+        int parent = (pos - 1) / 2;
+        if (!earlier(pos, parent)) break;
+        swapNodes(pos, parent);
+        pos = parent;
+    }
+}
+
+void ReviewScheduler::siftDown(int pos) {
+    int count = static_cast<int>(heap.size());
+    while (true) {
+        int smallest = pos;
+        int left = pos * 2 + 1;
+        int right = left + 1;
+        if (left < count && earlier(left, smallest)) smallest = left;
+        if (right < count && earlier(right, smallest)) smallest = right;
+        if (smallest == pos) break;
+        swapNodes(pos, smallest);
+        pos = smallest;
+    }
+}
+
+void ReviewScheduler::pushHeap(int wordIndex) {
+    int pos = static_cast<int>(heap.size());
+    positions[wordIndex] = pos;
+    heap.push_back(wordIndex);
+    siftUp(pos);
+}
+
+void ReviewScheduler::removeHeap(int wordIndex) {
+    int pos = positions[wordIndex];
+    if (pos < 0) return;
+    // 与末尾交换后弹出，再把换过来的节点调整到正确位置
+    int last = static_cast<int>(heap.size()) - 1;
+    swapNodes(pos, last);
+    heap.pop_back();
+    positions[wordIndex] = -1;
+    if (pos < last) {
+        int moved = heap[pos];
+        siftUp(pos);
+        siftDown(positions[moved]);
+    }
+}
+
+void ReviewScheduler::enqueue(int wordIndex) {
+    if (!wheel.insert(wordIndex, cards[wordIndex].due)) {
+        pushHeap(wordIndex);
+    }
+}
+
+void ReviewScheduler::build(std::vector<CardSchedule> schedules, const std::vector<bool>& active, int64_t now) {
+    cards = std::move(schedules);
+    heap.clear();
+    positions.assign(cards.size(), -1);
+    wheel.reset(cards.size(), now);
+    for (size_t i = 0; i < cards.size() && i < active.size(); i++) {
+        if (active[i] && !wheel.insert(static_cast<int>(i), cards[i].due)) {
+            positions[i] = static_cast<int>(heap.size());
+            heap.push_back(static_cast<int>(i));
+        }
+    }
+    for (int i = static_cast<int>(heap.size()) / 2 - 1; i >= 0; i--) {
+        siftDown(i);
+    }
+}
+
+void ReviewScheduler::update(int wordIndex, const CardSchedule& card, bool active) {
+    if (wordIndex < 0 || wordIndex >= static_cast<int>(cards.size())) {
+        return;
+    }
+    removeHeap(wordIndex);
+    wheel.erase(wordIndex);
+    cards[wordIndex] = card;
+    if (active) {
+        enqueue(wordIndex);
+    }
+}
+
+void ReviewScheduler::postpone(int wordIndex, int64_t until) {
+    if (wordIndex < 0 || wordIndex >= static_cast<int>(cards.size()) || positions[wordIndex] < 0) {
+        return;
+    }
+    removeHeap(wordIndex);
+    cards[wordIndex].due = until;
+    enqueue(wordIndex);
+}
+
+size_t ReviewScheduler::dueCount(int64_t now) {
+    advance(now);
+    size_t count = 0;
+    dueStack.clear();
+    if (!heap.empty()) dueStack.push_back(0);
+    while (!dueStack.empty()) {
+        int pos = dueStack.back();
+        dueStack.pop_back();
+        // 父节点没有到期时，整棵子树都没有到期
+        if (cards[heap[pos]].due > now) continue;
+        count++;
+        int child = pos * 2 + 1;
+        if (child < static_cast<int>(heap.size())) dueStack.push_back(child);
+        if (child + 1 < static_cast<int>(heap.size())) dueStack.push_back(child + 1);
+    }
+    return count;
+}
+
+void ReviewScheduler::advance(int64_t now) {
+    expired.clear();
+    wheel.advance(now, expired);
+    for (int wordIndex : expired) {
+        pushHeap(wordIndex);
+    }
+}
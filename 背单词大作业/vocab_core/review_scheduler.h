@@ -0,0 +1,96 @@
+﻿#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#include "timing_wheel.h"
+
+// ---------------- 间隔重复调度（SM-2） ----------------
+// 每个单词记录复习间隔、难度系数和下次复习时间。评分后按 SM-2 算法
+// 计算新的间隔。还没到期的单词挂在分层时间轮上，时钟走到时才移入按到期时间
+// 排序的最小堆：取下一个到期单词 O(1)，评分后重新安排 O(log n)，
+// 打开会话时不需要扫描全部已学单词。
+
+// 单个单词的复习计划，全零表示从未复习过
+struct CardSchedule {
+    int64_t due;          // 下次复习时间（Unix 秒），0 表示立即可复习
+    uint32_t interval;    // 当前复习间隔（天）
+    uint16_t ease;        // 难度系数 × 1000，首次评分时取 2500，最低 1300
+    uint16_t repetitions; // 连续答对的次数
+};
+
+static_assert(sizeof(CardSchedule) == 16, "复习计划布局不可改变");
+
+// 把界面上的熟悉度评分换算成 SM-2 的回答质量（0-5）：
+// 不熟悉 0，一般 3，熟悉 4，非常熟悉 5
+int ratingQuality(int familiarity);
+
+// 按一次评分更新复习计划，now 为评分时间（Unix 秒）
+void applyReview(CardSchedule& card, int familiarity, int64_t now);
+
+// 复习队列：未来到期的单词在时间轮中等待，当前刻度（1 小时）内到期的单词进入最小堆。
+// positions 记录每个单词在堆中的位置，因此可以直接修改或删除任意单词，而不必先查找它。
+class ReviewScheduler {
+private:
+    std::vector<CardSchedule> cards;
+    std::vector<int> heap;      // 按 due 排序的单词下标
+    std::vector<int> positions; // positions[单词下标] = 在 heap 中的位置，不在堆中为 -1
+    TimingWheel wheel;          // 尚未到期的单词
+    std::vector<int> expired;   // 推进时钟时取出的单词，缓冲区复用
+    std::vector<int> dueStack;  // dueCount 遍历堆时的栈，缓冲区复用
+
+    bool earlier(int a, int b) const {
+        return cards[heap[a]].due < cards[heap[b]].due;
+    }
+
+    void swapNodes(int a, int b);
+    void siftUp(int pos);
+    void siftDown(int pos);
+    void pushHeap(int wordIndex);
+    void removeHeap(int wordIndex);
+
+    // 单词按到期时间进入时间轮，已经到期的直接进堆
+    void enqueue(int wordIndex);
+
+public:
+    // 用已有的复习计划重建，时钟设为 now；active[i] 为 true 的单词参与复习，O(n)
+    void build(std::vector<CardSchedule> schedules, const std::vector<bool>& active, int64_t now);
+
+    // 修改单词的复习计划，active 决定它是否留在复习队列中，O(log n)
+    void update(int wordIndex, const CardSchedule& card, bool active);
+
+    // 推进时钟，把到期的单词从时间轮移入堆（每个单词均摊 O(1) 次搬动 + O(log n) 入堆）
+    void advance(int64_t now);
+
+    // 把堆中的单词推迟到 until 再复习，只改到期时间，间隔和难度不变；不在堆中时不做任何事
+    void postpone(int wordIndex, int64_t until);
+
+    // 推进到 now 后已到期的单词数。按堆序只访问到期的节点和它们的子节点，O(到期数)；
+    // 遍历用的栈在调用之间复用，栈够大之后不再分配内存
+    size_t dueCount(int64_t now);
+
+    const CardSchedule& schedule(int wordIndex) const { return cards[wordIndex]; }
+    const std::vector<CardSchedule>& schedules() const { return cards; }
+
+    // 复习队列中的单词总数（已到期和未到期）
+    size_t size() const { return heap.size() + wheel.size(); }
+
+    size_t memoryBytes() const {
+        return cards.capacity() * sizeof(CardSchedule) +
+            (heap.capacity() + positions.capacity() + expired.capacity() + dueStack.capacity()) * sizeof(int) +
+            wheel.memoryBytes();
+    }
+
+    // 推进到 now 后最早到期的单词；它在 now 之前到期时返回其下标，否则返回 -1
+    int nextDue(int64_t now) {
+        advance(now);
+        if (heap.empty() || cards[heap[0]].due > now) return -1;
+        return heap[0];
+    }
+
+    // 最早的到期时间，队列为空时返回 -1
+    int64_t earliestDue() const {
+        return heap.empty() ? wheel.earliest() : cards[heap[0]].due;
+    }
+};
@@ -0,0 +1,86 @@
+﻿#include "string_arena.h"
+
+#include <cstring>
+
+const size_t ARENA_INITIAL_BYTES = 64 * 1024;
+const size_t INTERN_INITIAL_SLOTS = 1024;
+
+void StringArena::grow(size_t required) {
+    size_t capacity = buffer.size() < ARENA_INITIAL_BYTES ? ARENA_INITIAL_BYTES : buffer.size();
+    while (capacity < required) capacity *= 2;
+    buffer.resize(capacity);
+    allocations++;
+}
+
+void StringArena::reserve(size_t bytes, size_t internCount) {
+    if (bytes > buffer.size()) {
+        buffer.resize(bytes);
+        allocations++;
+    }
+    size_t capacity = INTERN_INITIAL_SLOTS;
+    while (capacity < internCount * 2) capacity *= 2;
+    if (internCount > 0 && capacity > slots.size()) {
+        rehash(capacity);
+    }
+}
+
+uint32_t StringArena::append(std::string_view str) {
+    if (used + str.size() > buffer.size()) {
+        grow(used + str.size());
+    }
+    uint32_t offset = static_cast<uint32_t>(used);
+    if (!str.empty()) {
+        std::memcpy(buffer.data() + used, str.data(), str.size());
+    }
+    used += str.size();
+    return offset;
+}
+
+// FNV-1a，结果为 0 时改为 1，0 留给空槽
+uint32_t StringArena::hashOf(std::string_view str) {
+    uint32_t hash = 2166136261u;
+    for (char c : str) {
+        hash = (hash ^ static_cast<unsigned char>(c)) * 16777619u;
+    }
+    return hash == 0 ? 1 : hash;
+}
+
+void StringArena::rehash(size_t capacity) {
+    std::vector<InternSlot> old;
+    old.swap(slots);
+    slots.assign(capacity, InternSlot{ 0, 0, 0 });
+    allocations++;
+    size_t mask = capacity - 1;
+    for (const InternSlot& slot : old) {
+        if (slot.hash == 0) continue;
+        size_t i = slot.hash & mask;
+        while (slots[i].hash != 0) i = (i + 1) & mask;
+        slots[i] = slot;
+    }
+}
+
+uint32_t StringArena::intern(std::string_view str) {
+    // 装载率超过一半时扩容，保持线性探测的查找很短
+    if ((internedCount + 1) * 2 > slots.size()) {
+        rehash(slots.empty() ? INTERN_INITIAL_SLOTS : slots.size() * 2);
+    }
+
+    uint32_t hash = hashOf(str);
+    size_t mask = slots.size() - 1;
+    size_t i = hash & mask;
+    while (slots[i].hash != 0) {
+        const InternSlot& slot = slots[i];
+        if (slot.hash == hash && slot.length == str.size() &&
+            (str.empty() || std::memcmp(buffer.data() + slot.offset, str.data(), str.size()) == 0)) {
+            reusedCount++;
+            savedBytes += str.size();
+            return slot.offset;
+        }
+        i = (i + 1) & mask;
+    }
+
+    uint32_t offset = append(str);
+    slots[i] = InternSlot{ offset, static_cast<uint32_t>(str.size()), hash };
+    internedCount++;
+    return offset;
+}
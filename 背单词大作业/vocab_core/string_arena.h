@@ -0,0 +1,49 @@
+﻿#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <string_view>
+#include <vector>
+
+// 连续的字符串区：字符串依次追加到同一块缓冲区，按偏移引用，不为每个字符串单独分配内存。
+// 缓冲区成倍扩容，加载整个词库通常只分配一两次。
+// intern() 会先查找内容相同的字符串并复用它的偏移，用于去除重复的释义。
+class StringArena {
+private:
+    struct InternSlot {
+        uint32_t offset;
+        uint32_t length;
+        uint32_t hash;    // 0 表示空槽
+    };
+
+    std::vector<char> buffer;
+    size_t used;
+    std::vector<InternSlot> slots; // 开放寻址哈希表，容量为 2 的幂
+    size_t internedCount;          // 哈希表中的字符串数
+    size_t allocations;            // 缓冲区和哈希表的扩容次数
+    size_t reusedCount;            // 命中已有字符串的次数
+    size_t savedBytes;             // 因复用而少写入的字节数
+
+    void grow(size_t required);
+    void rehash(size_t capacity);
+    static uint32_t hashOf(std::string_view str);
+
+public:
+    StringArena() : used(0), internedCount(0), allocations(0), reusedCount(0), savedBytes(0) {}
+
+    // 预留缓冲区和去重哈希表，避免加载过程中扩容
+    void reserve(size_t bytes, size_t internCount = 0);
+
+    // 追加字符串，返回它的偏移
+    uint32_t append(std::string_view str);
+
+    // 追加字符串；已有相同内容时直接返回已有的偏移
+    uint32_t intern(std::string_view str);
+
+    const char* data() const { return buffer.data(); }
+    size_t size() const { return used; }
+
+    size_t allocationCount() const { return allocations; }
+    size_t reuseCount() const { return reusedCount; }
+    size_t bytesSaved() const { return savedBytes; }
+};
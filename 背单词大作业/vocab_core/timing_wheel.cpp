@@ -0,0 +1,151 @@
+﻿#include "timing_wheel.h"
+
+TimingWheel::TimingWheel(int64_t resolutionSeconds)
+    : resolution(resolutionSeconds > 0 ? resolutionSeconds : 1), currentTick(0),
+    heads(OVERFLOW_SLOT + 1, -1), count(0) {}
+
+int64_t TimingWheel::tickOf(int64_t time) const {
+    int64_t tick = time / resolution;
+    if (time < 0 && tick * resolution != time) tick--; // 向下取整
+    return tick;
+}
+
+// 按距离当前刻度的远近选择层级；调用前保证 tick > currentTick
+int TimingWheel::slotFor(int64_t tick) const {
+    int64_t delta = tick - currentTick;
+    for (int level = 0; level < LEVELS; level++) {
+        if (delta < (int64_t(1) << (SLOT_BITS * (level + 1)))) {
+            return level * SLOTS_PER_LEVEL + static_cast<int>((tick >> (SLOT_BITS * level)) & (SLOTS_PER_LEVEL - 1));
+        }
+    }
+    return OVERFLOW_SLOT;
+}
+
+void TimingWheel::link(int id, int slot) {
+    prev[id] = -1;
+    next[id] = heads[slot];
+    if (heads[slot] >= 0) prev[heads[slot]] = id;
+    heads[slot] = id;
+    slotOf[id] = slot;
+    count++;
+}
+
+void TimingWheel::unlink(int id) {
+    int slot = slotOf[id];
+    if (prev[id] >= 0) next[prev[id]] = next[id];
+    else heads[slot] = next[id];
+    if (next[id] >= 0) prev[next[id]] = prev[id];
+    slotOf[id] = -1;
+    count--;
+}
+
+void TimingWheel::cascade(int slot, std::vector<int>& expired) {
+    int id = heads[slot];
+    heads[slot] = -1;
+    while (id >= 0) {
+        int following = next[id];
+        slotOf[id] = -1;
+        count--;
+        int64_t tick = tickOf(keys[id]);
+        if (tick <= currentTick) {
+            expired.push_back(id);
+        }
+        else {
+            link(id, slotFor(tick));
+        }
+        id = following;
+    }
+}
+
+int64_t TimingWheel::slotMinimum(int slot) const {
+    int64_t best = -1;
+    for (int id = heads[slot]; id >= 0; id = next[id]) {
+        if (best < 0 || keys[id] < best) best = keys[id];
+    }
+    return best;
+}
+
+void TimingWheel::reset(size_t capacity, int64_t now) {
+    heads.assign(OVERFLOW_SLOT + 1, -1);
+    next.assign(capacity, -1);
+    prev.assign(capacity, -1);
+    slotOf.assign(capacity, -1);
+    keys.assign(capacity, 0);
+    count = 0;
+    currentTick = tickOf(now);
+}
+
+bool TimingWheel::insert(int id, int64_t due) {
+    if (contains(id)) unlink(id);
+    int64_t tick = tickOf(due);
+    if (tick <= currentTick) return false;
+    keys[id] = due;
+    link(id, slotFor(tick));
+    return true;
+}
+
+void TimingWheel::erase(int id) {
+    if (contains(id)) unlink(id);
+}
+
+void TimingWheel::advance(int64_t now, std::vector<int>& expired) {
+    int64_t target = tickOf(now);
+    if (count == 0 && target > currentTick) {
+        currentTick = target; // 没有元素时直接跳到目标刻度
+        return;
+    }
+
+    const int64_t mask = SLOTS_PER_LEVEL - 1;
+    while (currentTick < target) {
+        currentTick++;
+
+        // 进入新的高层槽时先把它下放，高层在前，下放的元素可能继续落入低层的当前槽
+        if ((currentTick & mask) == 0) {
+            int64_t block = currentTick >> SLOT_BITS;
+            if ((block & mask) == 0) {
+                int64_t superBlock = block >> SLOT_BITS;
+                if ((superBlock & mask) == 0) {
+                    cascade(OVERFLOW_SLOT, expired);
+                }
+                cascade(2 * SLOTS_PER_LEVEL + static_cast<int>(superBlock & mask), expired);
+            }
+            cascade(SLOTS_PER_LEVEL + static_cast<int>(block & mask), expired);
+        }
+
+        // 第 0 层当前槽里的元素都在这个刻度到期
+        int slot = static_cast<int>(currentTick & mask);
+        for (int id = heads[slot]; id >= 0; id = next[id]) {
+            slotOf[id] = -1;
+            count--;
+            expired.push_back(id);
+        }
+        heads[slot] = -1;
+
+        if (count == 0) {
+            currentTick = target;
+        }
+    }
+}
+
+int64_t TimingWheel::earliest() const {
+    if (count == 0) return -1;
+
+    const int64_t mask = SLOTS_PER_LEVEL - 1;
+    int64_t best = -1;
+    // 每层按时间顺序找到第一个非空槽，层内更早的元素不会出现在更靠后的槽里
+    for (int level = 0; level < LEVELS; level++) {
+        int shift = SLOT_BITS * level;
+        int64_t base = currentTick >> shift;
+        for (int64_t step = 1; step <= SLOTS_PER_LEVEL; step++) {
+            int slot = level * SLOTS_PER_LEVEL + static_cast<int>((base + step) & mask);
+            if (heads[slot] >= 0) {
+                int64_t value = slotMinimum(slot);
+                if (best < 0 || value < best) best = value;
+                break;
+            }
+        }
+    }
+    int64_t overflow = slotMinimum(OVERFLOW_SLOT);
+    if (overflow >= 0 && (best < 0 || overflow < best)) best = overflow;
+    return best;
+}
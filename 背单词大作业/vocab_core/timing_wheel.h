@@ -0,0 +1,63 @@
+﻿#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+// 分层时间轮：按到期时间把元素挂到不同粒度的槽里。
+// 第 0 层每槽 1 个刻度（默认 1 小时），第 1 层每槽 64 个刻度，第 2 层每槽 4096 个刻度，
+// 更远的放在溢出链表。时钟前进时只处理走过的槽，高层槽到期后整体下放到低层，
+// 每个元素最多被搬动三次，因此插入、删除 O(1)，推进时钟均摊 O(1)。
+// 每个槽是用下标串起来的双向链表，元素可以在任意位置被直接摘下。
+class TimingWheel {
+private:
+    static const int SLOT_BITS = 6;
+    static const int SLOTS_PER_LEVEL = 1 << SLOT_BITS;
+    static const int LEVELS = 3;
+    static const int OVERFLOW_SLOT = SLOTS_PER_LEVEL * LEVELS;
+
+    int64_t resolution;           // 每个刻度的秒数
+    int64_t currentTick;          // 已经处理到的刻度
+    std::vector<int> heads;       // 每个槽的链表头，空槽为 -1
+    std::vector<int> next;        // 链表中的后继元素
+    std::vector<int> prev;        // 链表中的前驱元素
+    std::vector<int> slotOf;      // 元素所在的槽，不在时间轮中为 -1
+    std::vector<int64_t> keys;    // 元素的到期时间（秒）
+    size_t count;
+
+    int64_t tickOf(int64_t time) const;
+    int slotFor(int64_t tick) const;
+    void link(int id, int slot);
+    void unlink(int id);
+
+    // 把一个槽整体取下，里面的元素重新按到期时间放入时间轮
+    void cascade(int slot, std::vector<int>& expired);
+
+    // 槽里最早的到期时间，空槽返回 -1
+    int64_t slotMinimum(int slot) const;
+
+public:
+    explicit TimingWheel(int64_t resolutionSeconds = 60 * 60);
+
+    // 清空并把时钟设为 now，最多容纳 capacity 个元素（下标 0 ~ capacity-1）
+    void reset(size_t capacity, int64_t now);
+
+    // 放入一个元素；已经到期（与当前刻度相同或更早）时返回 false，由调用者直接处理
+    bool insert(int id, int64_t due);
+
+    void erase(int id);
+
+    bool contains(int id) const { return id >= 0 && id < static_cast<int>(slotOf.size()) && slotOf[id] >= 0; }
+    size_t size() const { return count; }
+
+    size_t memoryBytes() const {
+        return (heads.capacity() + next.capacity() + prev.capacity() + slotOf.capacity()) * sizeof(int) +
+            keys.capacity() * sizeof(int64_t);
+    }
+
+    // 把时钟推进到 now，所有在当前刻度内到期的元素追加到 expired 并移出时间轮
+    void advance(int64_t now, std::vector<int>& expired);
+
+    // 时间轮中最早的到期时间，为空时返回 -1（最多检查每层的一个槽）
+    int64_t earliest() const;
+};
@@ -0,0 +1,70 @@
+﻿#pragma once
+
+#include <cstdint>
+#include <random>
+#include <vector>
+
+// 按权重抽样的树状数组（Fenwick 树）。
+// 每个单词对应一个非负权重，修改单个权重和按权重抽取一个下标都是 O(log n)，
+// 不需要在每次抽取时重建候选列表。
+class WeightedSampler {
+private:
+    std::vector<int64_t> tree;  // 下标从 1 开始的前缀和树
+    std::vector<int> weights;   // 每个元素当前的权重
+    int64_t total;
+    size_t topBit;              // 不超过元素个数的最大 2 的幂，用于自顶向下查找
+
+public:
+    WeightedSampler() : total(0), topBit(0) {}
+
+    // 用给定权重在 O(n) 内重建
+    void build(const std::vector<int>& newWeights) {
+        weights = newWeights;
+        tree.assign(weights.size() + 1, 0);
+        total = 0;
+        for (size_t i = 1; i <= weights.size(); i++) {
+            tree[i] += weights[i - 1];
+            total += weights[i - 1];
+            size_t parent = i + (i & (0 - i));
+            if (parent <= weights.size()) {
+                tree[parent] += tree[i];
+            }
+        }
+        topBit = 1;
+        while (topBit * 2 <= weights.size()) topBit *= 2;
+    }
+
+    void set(size_t index, int weight) {
+        int64_t delta = static_cast<int64_t>(weight) - weights[index];
+        if (delta == 0) return;
+        weights[index] = weight;
+        total += delta;
+        for (size_t i = index + 1; i < tree.size(); i += i & (0 - i)) {
+            tree[i] += delta;
+        }
+    }
+
+    int64_t totalWeight() const { return total; }
+
+    size_t memoryBytes() const {
+        return tree.capacity() * sizeof(int64_t) + weights.capacity() * sizeof(int);
+    }
+
+    // 按权重随机抽取一个下标；总权重为 0 时返回 -1
+    int sample(std::mt19937& rng) const {
+        if (total <= 0) return -1;
+        std::uniform_int_distribution<int64_t> dis(0, total - 1);
+        int64_t target = dis(rng);
+
+        // 找到前缀和首次超过 target 的位置
+        size_t pos = 0;
+        for (size_t step = topBit; step > 0; step /= 2) {
+            size_t next = pos + step;
+            if (next < tree.size() && tree[next] <= target) {
+                pos = next;
+                target -= tree[next];
+            }
+        }
+        return static_cast<int>(pos); // pos 是 1 基下标的前一位，即 0 基下标
+    }
+};
@@ -0,0 +1,47 @@
+﻿#pragma once
+
+#include <cstddef>
+#include <vector>
+
+// 单词下标集合：用反向位置表记录每个单词在列表中的位置，
+// 插入、删除（与末尾交换后弹出）和查询都是 O(1)。列表内的顺序不保证。
+class WordBucket {
+private:
+    std::vector<int> items;      // 集合中的单词下标
+    std::vector<int> positions;  // positions[单词下标] = 在 items 中的位置，不在集合中为 -1
+
+public:
+    void clear() {
+        items.clear();
+        positions.clear();
+    }
+
+    void insert(int wordIndex) {
+        if (wordIndex >= static_cast<int>(positions.size())) {
+            positions.resize(wordIndex + 1, -1);
+        }
+        if (positions[wordIndex] >= 0) return;
+        positions[wordIndex] = static_cast<int>(items.size());
+        items.push_back(wordIndex);
+    }
+
+    void erase(int wordIndex) {
+        if (!contains(wordIndex)) return;
+        int pos = positions[wordIndex];
+        int last = items.back();
+        items[pos] = last;
+        positions[last] = pos;
+        items.pop_back();
+        positions[wordIndex] = -1;
+    }
+
+    bool contains(int wordIndex) const {
+        return wordIndex >= 0 && wordIndex < static_cast<int>(positions.size()) && positions[wordIndex] >= 0;
+    }
+
+    size_t size() const { return items.size(); }
+    bool empty() const { return items.empty(); }
+    int operator[](size_t i) const { return items[i]; }
+
+    size_t memoryBytes() const { return (items.capacity() + positions.capacity()) * sizeof(int); }
+};
@@ -0,0 +1,98 @@
+﻿#include "word_details.h"
+
+#include <fstream>
+
+#include "json.hpp"
+#include "word_library.h"
+
+using json = nlohmann::json;
+
+// 取对象中的字符串字段，字段不存在或不是字符串时返回空串
+static std::string stringField(const json& object, const char* key) {
+    auto it = object.find(key);
+    if (it == object.end() || !it->is_string()) return std::string();
+    return it->get<std::string>();
+}
+
+bool WordDetailsCache::load(const WordLibrary& library, int wordIndex, WordDetails& details) const {
+    uint64_t offset;
+    uint32_t length;
+    if (sourcePath.empty() || !library.sourceRange(wordIndex, offset, length)) {
+        return false;
+    }
+
+    // 源文件大小变了说明位置已经失效（下次启动会重建快照）
+    uint64_t size;
+    int64_t time;
+    if (!getFileStamp(sourcePath.c_str(), size, time) || size != library.sourceSize()) {
+        return false;
+    }
+
+    std::ifstream file(sourcePath, std::ios::binary);
+    std::string buffer(length, '\0');
+    if (!file.seekg(static_cast<std::streamoff>(offset)) || !file.read(&buffer[0], length)) {
+        return false;
+    }
+
+    json object = json::parse(buffer, nullptr, false);
+    if (!object.is_object() || stringField(object, "word") != library[wordIndex].word) {
+        return false;
+    }
+
+    auto translations = object.find("translations");
+    if (translations != object.end() && translations->is_array()) {
+        for (const json& item : *translations) {
+            if (!item.is_object()) continue;
+            WordTranslation t;
+            t.type = stringField(item, "type");
+            t.translation = stringField(item, "translation");
+            if (!t.translation.empty()) details.translations.push_back(std::move(t));
+        }
+    }
+
+    auto phrases = object.find("phrases");
+    if (phrases != object.end() && phrases->is_array()) {
+        for (const json& item : *phrases) {
+            if (!item.is_object()) continue;
+            WordPhrase p;
+            p.phrase = stringField(item, "phrase");
+            p.translation = stringField(item, "translation");
+            if (!p.phrase.empty()) details.phrases.push_back(std::move(p));
+        }
+    }
+    return true;
+}
+
+void WordDetailsCache::setSource(const char* path) {
+    sourcePath = path;
+    entries.clear();
+    lookup.clear();
+}
+
+const WordDetails* WordDetailsCache::get(const WordLibrary& library, int wordIndex) {
+    if (wordIndex < 0 || wordIndex >= static_cast<int>(library.size())) {
+        return nullptr;
+    }
+
+    auto found = lookup.find(wordIndex);
+    if (found != lookup.end()) {
+        // 移到最前面，表示最近用过
+        entries.splice(entries.begin(), entries, found->second);
+        hits++;
+        return &found->second->second;
+    }
+
+    misses++;
+    WordDetails details;
+    if (!load(library, wordIndex, details)) {
+        return nullptr;
+    }
+
+    if (entries.size() >= capacity && !entries.empty()) {
+        lookup.erase(entries.back().first);
+        entries.pop_back();
+    }
+    entries.emplace_front(wordIndex, std::move(details));
+    lookup[wordIndex] = entries.begin();
+    return &entries.front().second;
+}
@@ -0,0 +1,56 @@
+﻿#pragma once
+
+#include <cstddef>
+#include <list>
+#include <string>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+class WordLibrary;
+
+// 单词的详细信息：全部释义（带词性）和短语。启动时不加载，卡片显示时才从源文件读取。
+struct WordTranslation {
+    std::string type;         // 词性，例如 "n"、"adj"，可能为空
+    std::string translation;
+};
+
+struct WordPhrase {
+    std::string phrase;
+    std::string translation;
+};
+
+struct WordDetails {
+    std::vector<WordTranslation> translations;
+    std::vector<WordPhrase> phrases;
+};
+
+// 详细信息缓存：按快照中记录的位置只读取并解析单个单词对象，
+// 最近用过的若干个单词保留在 LRU 缓存中，来回翻看时不再读文件。
+class WordDetailsCache {
+private:
+    typedef std::list<std::pair<int, WordDetails>> EntryList;
+
+    std::string sourcePath;
+    size_t capacity;
+    EntryList entries;                                  // 最近使用的在前
+    std::unordered_map<int, EntryList::iterator> lookup;
+    size_t hits;
+    size_t misses;
+
+    // 从源文件读取并解析一个单词对象，失败时返回 false
+    bool load(const WordLibrary& library, int wordIndex, WordDetails& details) const;
+
+public:
+    explicit WordDetailsCache(size_t capacity = 16) : capacity(capacity), hits(0), misses(0) {}
+
+    // 设置源文件路径并清空缓存
+    void setSource(const char* path);
+
+    // 取得单词的详细信息；没有源文件位置、源文件已改变或读取失败时返回 nullptr。
+    // 返回的指针在下一次调用 get() 之前有效。
+    const WordDetails* get(const WordLibrary& library, int wordIndex);
+
+    size_t hitCount() const { return hits; }
+    size_t missCount() const { return misses; }
+};
@@ -0,0 +1,665 @@
+﻿#include "word_library.h"
+
+#include <algorithm>
+#include <atomic>
+#include <cctype>
+#include <chrono>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <iterator>
+#include <stdexcept>
+#include <string>
+#include <thread>
+
+#include "json.hpp"
+
+using json = nlohmann::json;
+
+// words.json 中一段字节范围 [begin, end)
+struct SourceRange {
+    size_t begin;
+    size_t end;
+};
+
+// 解析 words.json 的 SAX 处理器。
+// 只提取 Word 需要的 word、第一个 translation 和 familiarity，其余字段
+// （例如 phrases）直接跳过，不会构建 DOM，也不会为它们分配内存。
+// 层级约定: 1-顶层数组, 2-单词对象, 3-translations 数组, 4-translation 对象
+// 每个单词对象在源文件中的位置一起记入快照：提供了顶层对象的位置表时从表中取，
+// 流式解析时由 streamPosition（已读字节数）在对象开始和结束时算出。
+class WordSaxHandler : public json::json_sax_t {
+private:
+    enum class Field { Other, Word, Translations, Familiarity };
+
+    SnapshotBuilder& builder;
+    size_t positionOffset;  // 分块解析时，块在整个文件中的起始位置（用于报错）
+    const std::vector<SourceRange>* objects; // 顶层单词对象的位置表，可以为空
+    size_t objectIndex;     // 当前单词对象在位置表中的序号
+    const size_t* streamPosition; // 流式解析时已读的字节数，可以为空
+    size_t objectBegin;     // 流式解析时当前单词对象的起始位置
+    int depth;
+    Field field;            // 单词对象中当前键对应的字段
+    bool inTranslationText; // translation 对象中当前键是否为 "translation"
+    int translationCount;   // 当前单词已读过的 translation 对象数
+
+    // 当前单词的字段，缓冲区在单词之间复用
+    std::string currentWord;
+    std::string currentMeaning;
+    bool hasWord;
+    bool hasMeaning;
+    int currentFamiliarity;
+
+public:
+    std::string errorMessage;
+
+    explicit WordSaxHandler(SnapshotBuilder& builder, size_t positionOffset = 0,
+        const std::vector<SourceRange>* objects = nullptr, size_t firstObject = 0, const size_t* streamPosition = nullptr)
+        : builder(builder), positionOffset(positionOffset), objects(objects), objectIndex(firstObject),
+        streamPosition(streamPosition), objectBegin(0), depth(0), field(Field::Other), inTranslationText(false),
+        translationCount(0), hasWord(false), hasMeaning(false), currentFamiliarity(0) {}
+
+    bool null() override { return true; }
+    bool boolean(bool) override { return true; }
+    bool binary(binary_t&) override { return true; }
+
+    bool number_integer(number_integer_t val) override {
+        if (depth == 2 && field == Field::Familiarity) {
+            currentFamiliarity = static_cast<int>(val);
+        }
+        return true;
+    }
+
+    bool number_unsigned(number_unsigned_t val) override {
+        if (depth == 2 && field == Field::Familiarity) {
+            currentFamiliarity = static_cast<int>(val);
+        }
+        return true;
+    }
+
+    bool number_float(number_float_t, const string_t&) override { return true; }
+
+    bool string(string_t& val) override {
+        if (depth == 2 && field == Field::Word) {
+            currentWord.assign(val);
+            hasWord = true;
+        }
+        else if (depth == 4 && field == Field::Translations && inTranslationText && translationCount == 0) {
+            currentMeaning.assign(val);
+            hasMeaning = true;
+        }
+        return true;
+    }
+
+    bool start_object(std::size_t) override {
+        depth++;
+        if (depth == 1) {
+            errorMessage = "words.json 顶层必须是数组";
+            return false;
+        }
+        if (depth == 2) {
+            field = Field::Other;
+            translationCount = 0;
+            hasWord = false;
+            hasMeaning = false;
+            currentFamiliarity = 0;
+            // 解析器刚读完 '{'，还没有向后多读
+            if (streamPosition != nullptr) objectBegin = *streamPosition - 1;
+        }
+        else if (depth == 4) {
+            inTranslationText = false;
+        }
+        return true;
+    }
+
+    bool key(string_t& val) override {
+        if (depth == 2) {
+            if (val == "word") field = Field::Word;
+            else if (val == "translations") field = Field::Translations;
+            else if (val == "familiarity") field = Field::Familiarity;
+            else field = Field::Other;
+        }
+        else if (depth == 4 && field == Field::Translations) {
+            inTranslationText = (val == "translation");
+        }
+        return true;
+    }
+
+    bool end_object() override {
+        if (depth == 4 && field == Field::Translations) {
+            translationCount++;
+        }
+        else if (depth == 2) {
+            // 缺少 word 字段的条目无法显示，直接跳过
+            if (hasWord) {
+                uint64_t sourceOffset = 0;
+                uint32_t sourceLength = 0;
+                if (objects != nullptr && objectIndex < objects->size()) {
+                    sourceOffset = (*objects)[objectIndex].begin;
+                    sourceLength = static_cast<uint32_t>((*objects)[objectIndex].end - (*objects)[objectIndex].begin);
+                }
+                else if (streamPosition != nullptr) {
+                    sourceOffset = objectBegin;
+                    sourceLength = static_cast<uint32_t>(*streamPosition - objectBegin);
+                }
+                builder.add(currentWord, hasMeaning ? std::string_view(currentMeaning) : "暂无翻译",
+                    currentFamiliarity, sourceOffset, sourceLength);
+            }
+            objectIndex++;
+            field = Field::Other;
+        }
+        depth--;
+        return true;
+    }
+
+    bool start_array(std::size_t) override {
+        depth++;
+        return true;
+    }
+
+    bool end_array() override {
+        depth--;
+        return true;
+    }
+
+    bool parse_error(std::size_t position, const std::string&, const nlohmann::detail::exception& ex) override {
+        errorMessage = "第 " + std::to_string(positionOffset + position) + " 字节处解析失败: " + ex.what();
+        return false;
+    }
+};
+
+// 从输入流逐字节读取并记录已读字节数的迭代器。单线程时直接流式解析文件，
+// 不把整个文件读入内存，单词对象的位置由已读字节数得出
+class CountingStreamIterator {
+private:
+    std::streambuf* buffer; // 为空表示结尾
+    size_t* position;
+
+    bool atEnd() const {
+        return buffer == nullptr || buffer->sgetc() == std::char_traits<char>::eof();
+    }
+
+public:
+    using iterator_category = std::input_iterator_tag;
+    using value_type = char;
+    using difference_type = std::ptrdiff_t;
+    using pointer = const char*;
+    using reference = char;
+
+    CountingStreamIterator() : buffer(nullptr), position(nullptr) {}
+    CountingStreamIterator(std::streambuf* buffer, size_t* position) : buffer(buffer), position(position) {}
+
+    char operator*() const { return std::char_traits<char>::to_char_type(buffer->sgetc()); }
+
+    CountingStreamIterator& operator++() {
+        buffer->sbumpc();
+        ++*position;
+        return *this;
+    }
+
+    bool operator==(const CountingStreamIterator& other) const { return atEnd() == other.atEnd(); }
+    bool operator!=(const CountingStreamIterator& other) const { return atEnd() != other.atEnd(); }
+};
+
+// ---------------- 分块解析 ----------------
+// 多线程解析大文件时，先把整个文件读入内存，顺序扫描一遍文件结构（只跟踪字符串和
+// 括号层级，比完整解析快得多），记下顶层数组中每个单词对象的位置，再按位置表在
+// 对象边界处切成若干块，各线程把自己的块包在 "[...]" 中用 SAX 解析到独立的构建器，
+// 最后按原顺序合并。位置表同时给出写进快照的单词对象位置。
+
+const size_t PARALLEL_MIN_FILE_BYTES = 1024 * 1024;  // 小于此大小的文件直接顺序解析
+const size_t PARALLEL_MIN_CHUNK_BYTES = 256 * 1024;  // 每块至少这么大，避免线程开销超过收益
+const size_t PARALLEL_CHUNKS_PER_THREAD = 4;         // 多切几块，让先做完的线程继续领取
+
+// 把 [data, data + length) 当作 "[" + 内容 + "]" 逐字节读出的迭代器，
+// 分块解析时不必复制块的内容
+class BracketedIterator {
+private:
+    const char* data;
+    int64_t length;
+    int64_t pos; // -1 为 '['，length 为 ']'
+
+public:
+    using iterator_category = std::forward_iterator_tag;
+    using value_type = char;
+    using difference_type = std::ptrdiff_t;
+    using pointer = const char*;
+    using reference = char;
+
+    BracketedIterator(const char* data, size_t length, int64_t pos)
+        : data(data), length(static_cast<int64_t>(length)), pos(pos) {}
+
+    char operator*() const {
+        if (pos < 0) return '[';
+        if (pos >= length) return ']';
+        return data[pos];
+    }
+
+    BracketedIterator& operator++() {
+        pos++;
+        return *this;
+    }
+
+    BracketedIterator operator++(int) {
+        BracketedIterator old = *this;
+        pos++;
+        return old;
+    }
+
+    bool operator==(const BracketedIterator& other) const { return pos == other.pos; }
+    bool operator!=(const BracketedIterator& other) const { return pos != other.pos; }
+};
+
+// 一个解析块：源文件范围和块中第一个对象在位置表中的序号
+struct JsonChunk {
+    SourceRange range;
+    size_t firstObject;
+};
+
+// 扫描顶层数组，记录每个顶层对象的位置，closing 为顶层数组的 ']'。
+// 文件不是以数组开头或结构不完整时返回 false，交给 SAX 解析报告具体错误。
+static bool indexTopLevelObjects(const char* data, size_t size, std::vector<SourceRange>& objects, size_t& closing) {
+    size_t pos = 0;
+    if (size >= 3 && std::memcmp(data, "\xEF\xBB\xBF", 3) == 0) pos = 3;
+    while (pos < size && std::isspace(static_cast<unsigned char>(data[pos]))) pos++;
+    if (pos >= size || data[pos] != '[') return false;
+    pos++;
+
+    objects.clear();
+    int depth = 1;
+    for (; pos < size; pos++) {
+        char c = data[pos];
+        if (c == '"') {
+            // 跳过字符串：找下一个前面没有奇数个反斜杠的引号
+            size_t from = pos + 1;
+            while (true) {
+                const void* found = std::memchr(data + from, '"', size - from);
+                if (found == nullptr) return false;
+                size_t quote = static_cast<const char*>(found) - data;
+                size_t backslashes = 0;
+                while (quote - backslashes > pos + 1 && data[quote - 1 - backslashes] == '\\') backslashes++;
+                if (backslashes % 2 == 0) {
+                    pos = quote;
+                    break;
+                }
+                from = quote + 1;
+            }
+        }
+        else if (c == '{' || c == '[') {
+            if (depth == 1 && c == '{') {
+                objects.push_back(SourceRange{ pos, pos });
+            }
+            depth++;
+        }
+        else if (c == '}' || c == ']') {
+            depth--;
+            if (depth == 1 && c == '}' && !objects.empty()) {
+                objects.back().end = pos + 1;
+            }
+            else if (depth == 0) {
+                closing = pos;
+                return true;
+            }
+        }
+    }
+    return false;
+}
+
+// 按位置表把顶层数组切成大约 chunkCount 块，每块到下一块第一个对象前的逗号为止
+static void splitChunks(const char* data, const std::vector<SourceRange>& objects, size_t closing,
+    size_t chunkCount, std::vector<JsonChunk>& chunks) {
+    chunks.clear();
+    if (objects.empty()) return;
+
+    size_t span = (closing - objects.front().begin) / chunkCount + 1;
+    size_t nextTarget = objects.front().begin;
+    for (size_t i = 0; i < objects.size(); i++) {
+        if (objects[i].begin >= nextTarget) {
+            chunks.push_back(JsonChunk{ SourceRange{ objects[i].begin, closing }, i });
+            nextTarget = objects[i].begin + span;
+        }
+    }
+    for (size_t i = 0; i + 1 < chunks.size(); i++) {
+        size_t begin = chunks[i].range.begin;
+        size_t end = chunks[i + 1].range.begin;
+        while (end > begin && data[end - 1] != ',') end--;
+        if (end > begin) end--;
+        chunks[i].range.end = end;
+    }
+}
+
+// 在多个线程上解析各块，再按原顺序合并到 builder
+static void parseChunksParallel(const std::vector<char>& data, const std::vector<SourceRange>& objects,
+    const std::vector<JsonChunk>& chunks, unsigned threadCount, SnapshotBuilder& builder, LoadStats& stats) {
+    std::vector<SnapshotBuilder> parts(chunks.size());
+    std::vector<std::string> errors(chunks.size());
+    std::atomic<size_t> nextChunk(0);
+    auto worker = [&]() {
+        size_t i;
+        while ((i = nextChunk.fetch_add(1)) < chunks.size()) {
+            const char* begin = data.data() + chunks[i].range.begin;
+            size_t length = chunks[i].range.end - chunks[i].range.begin;
+            parts[i].reserve(length / 512, length / 16);
+            // 块前面补了一个 '['，报错位置要减去它
+            WordSaxHandler handler(parts[i], chunks[i].range.begin - 1, &objects, chunks[i].firstObject);
+            if (!json::sax_parse(BracketedIterator(begin, length, -1),
+                BracketedIterator(begin, length, static_cast<int64_t>(length) + 1), &handler)) {
+                errors[i] = handler.errorMessage.empty() ? "words.json 格式错误" : handler.errorMessage;
+            }
+        }
+    };
+
+    unsigned workerCount = static_cast<unsigned>(std::min<size_t>(threadCount, chunks.size()));
+    std::vector<std::thread> workers;
+    for (unsigned i = 1; i < workerCount; i++) {
+        workers.emplace_back(worker);
+    }
+    worker(); // 当前线程也参与解析
+    for (std::thread& t : workers) {
+        t.join();
+    }
+
+    for (const std::string& error : errors) {
+        if (!error.empty()) throw std::runtime_error(error);
+    }
+
+    size_t wordCount = 0;
+    size_t stringBytes = 0;
+    for (const SnapshotBuilder& part : parts) {
+        wordCount += part.size();
+        stringBytes += part.stringBytes();
+        stats.allocations += part.allocationCount();
+    }
+    builder.reserve(wordCount, stringBytes);
+    for (const SnapshotBuilder& part : parts) {
+        builder.appendFrom(part);
+    }
+
+    stats.threads = workerCount;
+    stats.chunks = chunks.size();
+}
+
+WordLibrary::WordLibrary() : gen(std::random_device{}()), stats() {}
+
+WordLibrary::WordLibrary(uint32_t seed) : gen(seed), stats() {}
+
+MemoryUsage WordLibrary::memoryUsage() const {
+    MemoryUsage usage;
+    usage.storeBytes = store.byteSize();
+    usage.indexBytes = table.memoryBytes() + unlearnedWords.memoryBytes() + learnedWords.memoryBytes() +
+        reviewSampler.memoryBytes() + scheduler.memoryBytes() + prefixIndex.memoryBytes() +
+        fuzzyIndex.memoryBytes();
+    return usage;
+}
+
+int reviewWeight(uint8_t status) {
+    int familiarity = statusFamiliarity(status);
+    if (!statusLearned(status) || familiarity >= 3) {
+        return 0;
+    }
+    return 3 - familiarity;
+}
+
+Word WordLibrary::operator[](size_t index) const {
+    Word word;
+    word.word = table.word(index);
+    word.meaning = table.meaning(index);
+    word.familiarity = table.familiarity(index);
+    word.learned = table.learned(index);
+    return word;
+}
+
+void WordLibrary::attachStore() {
+    table.attach(store);
+    rebuildIndexes();
+    prefixIndex.build(store);
+    fuzzyIndex.build(store);
+
+    // 词库自带的熟悉度没有复习记录，已学习的单词视为立即到期
+    std::vector<bool> active(table.size());
+    for (size_t i = 0; i < table.size(); i++) {
+        active[i] = table.learned(i);
+    }
+    scheduler.build(std::vector<CardSchedule>(table.size()), active, 0);
+}
+
+// 分类列表和抽样权重只由状态字节决定，重建时不访问字符串
+void WordLibrary::rebuildIndexes() {
+    unlearnedWords.clear();
+    learnedWords.clear();
+
+    const std::vector<uint8_t>& status = table.statuses();
+    std::vector<int> weights(status.size());
+    for (size_t i = 0; i < status.size(); i++) {
+        if (statusLearned(status[i])) {
+            learnedWords.insert(static_cast<int>(i));
+        }
+        else if (statusFamiliarity(status[i]) == 0) {
+            unlearnedWords.insert(static_cast<int>(i));
+        }
+        weights[i] = reviewWeight(status[i]);
+    }
+    reviewSampler.build(weights);
+}
+
+bool WordLibrary::loadFromJSON(const char* path, unsigned threadCount) {
+    try {
+        auto startTime = std::chrono::steady_clock::now();
+
+        uint64_t sourceSize = 0;
+        int64_t sourceTime = 0;
+        std::ifstream file(path, std::ios::binary);
+        if (!file.is_open() || !getFileStamp(path, sourceSize, sourceTime)) {
+            throw std::runtime_error(std::string("无法打开 ") + path + " 文件");
+        }
+
+        if (threadCount == 0) {
+            threadCount = std::max(1u, std::thread::hardware_concurrency());
+        }
+
+        SnapshotBuilder builder;
+        LoadStats result = LoadStats();
+        result.threads = 1;
+        result.chunks = 1;
+        if (threadCount > 1 && sourceSize >= PARALLEL_MIN_FILE_BYTES) {
+            // 整个文件读入内存：结构扫描、分块和位置表都基于同一块缓冲区。
+            // 峰值内存多出文件大小和位置表，换取多核并行解析
+            std::vector<char> data(static_cast<size_t>(sourceSize));
+            if (!file.read(data.data(), static_cast<std::streamsize>(data.size()))) {
+                throw std::runtime_error(std::string("无法读取 ") + path + " 文件");
+            }
+            file.close();
+
+            std::vector<SourceRange> objects;
+            objects.reserve(static_cast<size_t>(sourceSize / 512));
+            size_t closing = 0;
+            bool indexed = indexTopLevelObjects(data.data(), data.size(), objects, closing);
+            result.allocations = 2; // 文件缓冲区和位置表
+
+            size_t chunkTarget = std::min<size_t>(threadCount * PARALLEL_CHUNKS_PER_THREAD,
+                static_cast<size_t>(sourceSize / PARALLEL_MIN_CHUNK_BYTES));
+            std::vector<JsonChunk> chunks;
+            if (indexed && chunkTarget >= 2) {
+                splitChunks(data.data(), objects, closing, chunkTarget, chunks);
+            }
+
+            if (chunks.size() >= 2) {
+                parseChunksParallel(data, objects, chunks, threadCount, builder, result);
+            }
+            else {
+                // 切不开（例如结构不完整）时在同一块缓冲区上顺序解析，由 SAX 报告具体错误
+                builder.reserve(static_cast<size_t>(sourceSize / 512), static_cast<size_t>(sourceSize / 16));
+                WordSaxHandler handler(builder, 0, indexed ? &objects : nullptr);
+                if (!json::sax_parse(data.data(), data.data() + data.size(), &handler)) {
+                    throw std::runtime_error(handler.errorMessage.empty() ? "words.json 格式错误" : handler.errorMessage);
+                }
+            }
+        }
+        else {
+            // 流式解析：内存中只保留提取出的字段。
+            // 按源文件大小预留：每个单词的 JSON 远大于 512 字节，提取出的字符串不到源文件的 1/16，
+            // 通常一次分配就够，估计不足时再成倍扩容
+            builder.reserve(static_cast<size_t>(sourceSize / 512), static_cast<size_t>(sourceSize / 16));
+            size_t position = 0;
+            WordSaxHandler handler(builder, 0, nullptr, 0, &position);
+            if (!json::sax_parse(CountingStreamIterator(file.rdbuf(), &position), CountingStreamIterator(), &handler)) {
+                throw std::runtime_error(handler.errorMessage.empty() ? "words.json 格式错误" : handler.errorMessage);
+            }
+        }
+
+        if (!store.adopt(builder.finish(sourceSize, sourceTime))) {
+            throw std::runtime_error("words.json 中的数据无效");
+        }
+        attachStore();
+
+        stats = result;
+        stats.bytes = sourceSize;
+        stats.seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - startTime).count();
+        stats.allocations += builder.allocationCount() + 1; // 加上快照镜像本身
+        stats.stringBytes = builder.stringBytes();
+        stats.sharedMeanings = builder.sharedMeanings();
+        stats.savedBytes = builder.bytesSaved();
+        return true;
+    }
+    catch (const std::exception& e) {
+        std::cerr << "加载单词库错误: " << e.what() << std::endl;
+        return false;
+    }
+}
+
+bool WordLibrary::loadFromSnapshot(const char* snapshotPath, const char* sourcePath) {
+    auto startTime = std::chrono::steady_clock::now();
+
+    if (!store.open(snapshotPath)) {
+        return false;
+    }
+
+    // 源文件存在且与生成快照时不同，说明快照已过期
+    uint64_t sourceSize;
+    int64_t sourceTime;
+    if (getFileStamp(sourcePath, sourceSize, sourceTime) &&
+        (sourceSize != store.sourceSize() || sourceTime != store.sourceTime())) {
+        store.close();
+        return false;
+    }
+
+    attachStore();
+
+    stats = LoadStats();
+    stats.bytes = store.byteSize();
+    stats.seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - startTime).count();
+    return true;
+}
+
+bool WordLibrary::loadFromImage(std::vector<char>&& image) {
+    if (!store.adopt(std::move(image))) {
+        return false;
+    }
+    attachStore();
+    stats = LoadStats();
+    stats.bytes = store.byteSize();
+    return true;
+}
+
+bool WordLibrary::saveSnapshot(const char* path) const {
+    if (!store.isOpen()) {
+        return false;
+    }
+
+    std::string tmpPath = std::string(path) + ".tmp";
+    {
+        std::ofstream out(tmpPath, std::ios::binary | std::ios::trunc);
+        if (!out.is_open()) {
+            std::cerr << "无法写入快照文件: " << tmpPath << std::endl;
+            return false;
+        }
+        out.write(store.bytes(), store.byteSize());
+        if (!out) {
+            std::cerr << "写入快照文件失败: " << tmpPath << std::endl;
+            return false;
+        }
+    }
+
+    std::error_code ec;
+    std::filesystem::rename(tmpPath, path, ec);
+    if (ec) {
+        std::cerr << "替换快照文件失败: " << ec.message() << std::endl;
+        std::filesystem::remove(tmpPath, ec);
+        return false;
+    }
+    return true;
+}
+
+int WordLibrary::getRandomUnlearnedWord() {
+    if (unlearnedWords.empty()) {
+        return -1; // 没有未学习的单词
+    }
+
+    std::uniform_int_distribution<> dis(0, static_cast<int>(unlearnedWords.size()) - 1);
+    return unlearnedWords[dis(gen)];
+}
+
+int WordLibrary::getRandomLearnedWord() {
+    return reviewSampler.sample(gen); // 没有需要复习的单词时返回 -1
+}
+
+void WordLibrary::updateWordStatus(int wordIndex, int newFamiliarity, int64_t now) {
+    if (wordIndex < 0 || wordIndex >= static_cast<int>(table.size())) {
+        return;
+    }
+
+    // 从现有列表中移除（O(1)）
+    unlearnedWords.erase(wordIndex);
+    learnedWords.erase(wordIndex);
+
+    // 根据新的熟悉度重新分类
+    bool learned = familiarityLearned(newFamiliarity); // 非常熟悉的单词不加入任何列表
+    table.set(wordIndex, newFamiliarity, learned);
+    if (newFamiliarity == 0) {
+        unlearnedWords.insert(wordIndex);
+    }
+    else if (learned) {
+        learnedWords.insert(wordIndex);
+    }
+
+    reviewSampler.set(wordIndex, reviewWeight(table.statusOf(wordIndex)));
+
+    // 评为"不熟悉"的单词回到未学习列表，评为"非常熟悉"的单词算作学完，都离开复习队列；
+    // 它们的复习记录仍然保留，以后重新评分时接着计算（不熟悉的单词难度系数更低，间隔增长得更慢）
+    CardSchedule card = scheduler.schedule(wordIndex);
+    applyReview(card, newFamiliarity, now);
+    scheduler.update(wordIndex, card, learned);
+}
+
+size_t WordLibrary::applyProgress(const std::vector<uint8_t>& familiarity,
+    const std::vector<CardSchedule>& schedules, int64_t now) {
+    if (familiarity.size() != table.size() || schedules.size() != table.size()) {
+        return 0;
+    }
+
+    size_t changed = 0;
+    std::vector<bool> active(table.size());
+    for (size_t i = 0; i < table.size(); i++) {
+        if (table.familiarity(i) != familiarity[i]) {
+            changed++;
+        }
+        table.set(i, familiarity[i], familiarityLearned(familiarity[i]));
+        active[i] = table.learned(i);
+    }
+
+    rebuildIndexes();
+    scheduler.build(schedules, active, now);
+    return changed;
+}
+
+uint64_t WordLibrary::computeHash() const {
+    uint64_t hash = 14695981039346656037ULL;
+    for (size_t i = 0; i < table.size(); i++) {
+        for (char c : table.word(i)) {
+            hash = (hash ^ static_cast<unsigned char>(c)) * 1099511628211ULL;
+        }
+        hash = (hash ^ 0xFF) * 1099511628211ULL;
+    }
+    return hash;
+}
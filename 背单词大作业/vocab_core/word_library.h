@@ -0,0 +1,161 @@
+﻿#pragma once
+
+#include <cstdint>
+#include <random>
+#include <string_view>
+#include <vector>
+
+#include "fuzzy_index.h"
+#include "prefix_index.h"
+#include "review_scheduler.h"
+#include "weighted_sampler.h"
+#include "word_bucket.h"
+#include "word_store.h"
+#include "word_table.h"
+
+// 单个单词的视图，由 WordTable 按需组装（字符串指向 WordStore 中的只读数据，不单独分配内存）
+struct Word {
+    std::string_view word;
+    std::string_view meaning;
+    int familiarity; // 熟悉度: 0-不熟悉, 1-一般, 2-熟悉，3-非常熟悉
+    bool learned;    // 是否已学习
+
+    Word() : familiarity(0), learned(false) {}
+};
+
+// 最近一次加载的统计
+struct LoadStats {
+    uint64_t bytes;         // 解析的源文件字节数
+    double seconds;         // 用时
+    size_t allocations;     // 构建单词表时的内存分配次数（从快照加载时为 0）
+    size_t stringBytes;     // 字符串表字节数
+    size_t sharedMeanings;  // 复用已有释义的单词数
+    size_t savedBytes;      // 释义去重节省的字节数
+    unsigned threads;       // 解析 JSON 使用的线程数
+    size_t chunks;          // JSON 被切成的块数
+};
+
+// 单词库的内存占用
+struct MemoryUsage {
+    size_t storeBytes;  // 快照镜像（单词条目和字符串表）
+    size_t indexBytes;  // 状态表、分类列表、抽样器和复习队列
+};
+
+// 复习权重（按状态字节计算）：熟悉度越低权重越高，未学习和非常熟悉的单词不参与复习
+int reviewWeight(uint8_t status);
+
+// 单词库：保存全部单词、按学习状态分类的列表和复习抽样器。
+// 不依赖任何图形或 Windows 接口，可以在 Linux 上编译、测试和做性能测量。
+class WordLibrary {
+private:
+    WordStore store;                 // 单词字符串的存储区
+    WordTable table;                 // 单词表：状态字节数组 + 指向 store 的字符串
+    WordBucket unlearnedWords;
+    WordBucket learnedWords;
+    WeightedSampler reviewSampler;   // 复习抽样器：权重为复习优先级，随单词状态增量更新
+    ReviewScheduler scheduler;       // 间隔重复调度：已学过的单词按到期时间排队
+    PrefixIndex prefixIndex;         // 按单词排序的下标，用于按前缀查找
+    FuzzyIndex fuzzyIndex;           // 按长度分组的小写单词，用于查找拼写相近的单词
+    std::mt19937 gen;
+    LoadStats stats;
+
+    // 根据 store 重建单词库、分类列表和复习抽样器
+    void attachStore();
+
+    // 按当前熟悉度重建分类列表和复习抽样器，O(n)
+    void rebuildIndexes();
+
+public:
+    WordLibrary();
+    explicit WordLibrary(uint32_t seed);
+
+    WordLibrary(const WordLibrary&) = delete;
+    WordLibrary& operator=(const WordLibrary&) = delete;
+
+    // 从JSON文件加载单词库。大文件在顶层数组的单词边界处切块，用 threadCount 个线程
+    // 并行解析后按原顺序合并（0 表示使用全部硬件线程）；小文件或只用一个线程时直接流式解析，
+    // 不把整个文件读入内存
+    bool loadFromJSON(const char* path, unsigned threadCount = 0);
+
+    // 映射二进制快照并加载单词库；快照缺失、损坏或比 sourcePath 旧时返回 false
+    bool loadFromSnapshot(const char* snapshotPath, const char* sourcePath);
+
+    // 从内存中的快照镜像（SnapshotBuilder 的结果）加载单词库
+    bool loadFromImage(std::vector<char>&& image);
+
+    // 将当前词库的快照镜像写到磁盘（先写临时文件再替换，避免留下半个文件）
+    bool saveSnapshot(const char* path) const;
+
+    size_t size() const { return table.size(); }
+    Word operator[](size_t index) const;
+
+    // 单词对象在源文件（words.json）中的位置，没有记录位置时返回 false
+    bool sourceRange(size_t index, uint64_t& offset, uint32_t& length) const {
+        offset = store.sourceOffset(index);
+        length = store.sourceLength(index);
+        return length > 0;
+    }
+
+    // 生成单词库时源文件的大小，用于确认源文件没有被修改
+    uint64_t sourceSize() const { return store.isOpen() ? store.sourceSize() : 0; }
+    const WordTable& wordTable() const { return table; }
+
+    // 查找以 prefix 开头的单词（不区分大小写，按字母顺序），最多取 maxResults 个，
+    // 返回匹配的总数。O(log n + maxResults)
+    size_t searchPrefix(std::string_view prefix, size_t maxResults, std::vector<int>& results) const {
+        return prefixIndex.search(prefix, maxResults, results);
+    }
+
+    // 按单词查找下标（不区分大小写），找不到时返回 -1
+    int findWord(std::string_view word) const { return prefixIndex.find(word); }
+
+    // 查找与 word 的编辑距离不超过 maxDistance 的单词（不区分大小写），按距离从近到远排列，
+    // 最多取 maxResults 个，返回匹配的总数。只比较长度相近的单词
+    size_t searchSimilar(std::string_view word, int maxDistance, size_t maxResults, std::vector<FuzzyMatch>& results) const {
+        return fuzzyIndex.search(word, maxDistance, maxResults, results);
+    }
+
+    size_t unlearnedCount() const { return unlearnedWords.size(); }
+    size_t learnedCount() const { return learnedWords.size(); }
+
+    // 统计每种熟悉度的单词数（只扫描状态字节）
+    void countByFamiliarity(size_t counts[4]) const { table.countByFamiliarity(counts); }
+
+    // 随机选择一个未学习的单词，没有时返回 -1
+    int getRandomUnlearnedWord();
+
+    // 随机选择一个已学习的单词用于复习（按熟悉度加权，O(log n)），没有时返回 -1
+    int getRandomLearnedWord();
+
+    // 最早到期的复习单词，now 时还没有到期的单词时返回 -1
+    // （先把时钟推进到 now，之后取堆顶 O(1)）
+    int getNextDueWord(int64_t now) { return scheduler.nextDue(now); }
+
+    // 到 now 为止已到期的复习单词数
+    size_t dueCount(int64_t now) { return scheduler.dueCount(now); }
+
+    // 跳过一个到期的单词：until 之前不再由 getNextDueWord 取出，复习计划不变
+    void postponeReview(int wordIndex, int64_t until) { scheduler.postpone(wordIndex, until); }
+
+    // 下一个单词的到期时间，没有安排复习的单词时返回 -1
+    int64_t nextReviewTime() const { return scheduler.earliestDue(); }
+
+    size_t scheduledCount() const { return scheduler.size(); }
+    const CardSchedule& schedule(int wordIndex) const { return scheduler.schedule(wordIndex); }
+
+    // 评分：更新单词学习状态和复习计划
+    // （O(1) 分类 + O(log n) 更新抽样权重 + O(log n) 重新排队）
+    void updateWordStatus(int wordIndex, int newFamiliarity, int64_t now);
+
+    // 一次性套用保存的学习进度（熟悉度和复习计划），复习时钟设为 now，
+    // 返回熟悉度有变化的单词数
+    size_t applyProgress(const std::vector<uint8_t>& familiarity, const std::vector<CardSchedule>& schedules,
+        int64_t now);
+
+    // 计算单词库指纹（FNV-1a），词库内容变化后旧进度不会被错误套用
+    uint64_t computeHash() const;
+
+    const LoadStats& lastLoadStats() const { return stats; }
+
+    MemoryUsage memoryUsage() const;
+};
@@ -0,0 +1,196 @@
+﻿#include "word_store.h"
+
+#include <cstring>
+#include <filesystem>
+
+#ifdef _WIN32
+#define WIN32_LEAN_AND_MEAN
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+const char SNAPSHOT_MAGIC[4] = { 'W', 'L', 'I', 'B' };
+const uint32_t SNAPSHOT_VERSION = 2; // 2: 条目中增加了源文件位置
+
+bool getFileStamp(const char* path, uint64_t& size, int64_t& time) {
+    std::error_code ec;
+    size = std::filesystem::file_size(path, ec);
+    if (ec) return false;
+    auto mtime = std::filesystem::last_write_time(path, ec);
+    if (ec) return false;
+    time = static_cast<int64_t>(mtime.time_since_epoch().count());
+    return true;
+}
+
+void SnapshotBuilder::reserve(size_t wordCount, size_t stringBytes) {
+    if (wordCount > entries.capacity()) {
+        entries.reserve(wordCount);
+        entryAllocations++;
+    }
+    stringTable.reserve(stringBytes, internMeanings ? wordCount : 0);
+}
+
+void SnapshotBuilder::add(std::string_view word, std::string_view meaning, int familiarity,
+    uint64_t sourceOffset, uint32_t sourceLength) {
+    if (entries.size() == entries.capacity()) {
+        entryAllocations++;
+    }
+    SnapshotEntry entry;
+    entry.wordOffset = stringTable.append(word);
+    entry.wordLength = static_cast<uint32_t>(word.size());
+    entry.meaningOffset = internMeanings ? stringTable.intern(meaning) : stringTable.append(meaning);
+    entry.meaningLength = static_cast<uint32_t>(meaning.size());
+    // 手工编辑的 words.json 里可能有超出 0-3 的熟悉度，截到有效范围，不让整个词库加载失败
+    entry.familiarity = static_cast<uint32_t>(familiarity < 0 ? 0 : (familiarity > 3 ? 3 : familiarity));
+    entry.sourceLength = sourceLength;
+    entry.sourceOffset = sourceOffset;
+    entries.push_back(entry);
+}
+
+void SnapshotBuilder::appendFrom(const SnapshotBuilder& other) {
+    for (const SnapshotEntry& e : other.entries) {
+        add(std::string_view(other.stringTable.data() + e.wordOffset, e.wordLength),
+            std::string_view(other.stringTable.data() + e.meaningOffset, e.meaningLength),
+            static_cast<int>(e.familiarity), e.sourceOffset, e.sourceLength);
+    }
+}
+
+std::vector<char> SnapshotBuilder::finish(uint64_t sourceSize, int64_t sourceTime) const {
+    SnapshotHeader header = {};
+    std::memcpy(header.magic, SNAPSHOT_MAGIC, sizeof(header.magic));
+    header.version = SNAPSHOT_VERSION;
+    header.wordCount = static_cast<uint32_t>(entries.size());
+    header.stringTableSize = static_cast<uint32_t>(stringTable.size());
+    header.sourceSize = sourceSize;
+    header.sourceTime = sourceTime;
+
+    size_t entryBytes = entries.size() * sizeof(SnapshotEntry);
+    std::vector<char> image(sizeof(header) + entryBytes + stringTable.size());
+    std::memcpy(image.data(), &header, sizeof(header));
+    if (entryBytes > 0) {
+        std::memcpy(image.data() + sizeof(header), entries.data(), entryBytes);
+    }
+    if (stringTable.size() > 0) {
+        std::memcpy(image.data() + sizeof(header) + entryBytes, stringTable.data(), stringTable.size());
+    }
+    return image;
+}
+
+#ifdef _WIN32
+WordStore::WordStore() : data(nullptr), dataSize(0), mapped(false),
+    fileHandle(INVALID_HANDLE_VALUE), mappingHandle(nullptr) {}
+#else
+WordStore::WordStore() : data(nullptr), dataSize(0), mapped(false) {}
+#endif
+
+// 检查文件头和每个条目的偏移是否越界，防止损坏的文件导致越界读取。
+// SnapshotBuilder 生成的镜像熟悉度总在 0-3 之内，超出范围只可能是损坏的快照文件
+bool WordStore::validate() const {
+    if (dataSize < sizeof(SnapshotHeader)) return false;
+    const SnapshotHeader& h = header();
+    if (std::memcmp(h.magic, SNAPSHOT_MAGIC, sizeof(h.magic)) != 0 || h.version != SNAPSHOT_VERSION) {
+        return false;
+    }
+    uint64_t expectedSize = sizeof(SnapshotHeader) +
+        static_cast<uint64_t>(h.wordCount) * sizeof(SnapshotEntry) + h.stringTableSize;
+    if (expectedSize != dataSize) return false;
+
+    for (uint32_t i = 0; i < h.wordCount; i++) {
+        const SnapshotEntry& e = entry(i);
+        if (static_cast<uint64_t>(e.wordOffset) + e.wordLength > h.stringTableSize ||
+            static_cast<uint64_t>(e.meaningOffset) + e.meaningLength > h.stringTableSize ||
+            e.familiarity > 3 ||
+            (e.sourceLength > 0 && e.sourceOffset + e.sourceLength > h.sourceSize)) {
+            return false;
+        }
+    }
+    return true;
+}
+
+bool WordStore::open(const char* path) {
+    close();
+
+#ifdef _WIN32
+    fileHandle = CreateFileA(path, GENERIC_READ, FILE_SHARE_READ, nullptr,
+        OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+    if (fileHandle == INVALID_HANDLE_VALUE) return false;
+
+    LARGE_INTEGER fileSize;
+    if (!GetFileSizeEx(fileHandle, &fileSize) || fileSize.QuadPart == 0) {
+        close();
+        return false;
+    }
+
+    mappingHandle = CreateFileMappingA(fileHandle, nullptr, PAGE_READONLY, 0, 0, nullptr);
+    if (mappingHandle == nullptr) {
+        close();
+        return false;
+    }
+
+    data = static_cast<const char*>(MapViewOfFile(mappingHandle, FILE_MAP_READ, 0, 0, 0));
+    dataSize = static_cast<size_t>(fileSize.QuadPart);
+#else
+    int fd = ::open(path, O_RDONLY);
+    if (fd < 0) return false;
+
+    struct stat st;
+    if (fstat(fd, &st) != 0 || st.st_size == 0) {
+        ::close(fd);
+        return false;
+    }
+
+    // 映射建立后即可关闭文件描述符
+    void* view = mmap(nullptr, static_cast<size_t>(st.st_size), PROT_READ, MAP_SHARED, fd, 0);
+    ::close(fd);
+    data = view == MAP_FAILED ? nullptr : static_cast<const char*>(view);
+    dataSize = static_cast<size_t>(st.st_size);
+#endif
+
+    mapped = data != nullptr;
+    if (data == nullptr || !validate()) {
+        close();
+        return false;
+    }
+    return true;
+}
+
+bool WordStore::adopt(std::vector<char>&& image) {
+    close();
+    ownedImage = std::move(image);
+    data = ownedImage.data();
+    dataSize = ownedImage.size();
+    if (!validate()) {
+        close();
+        return false;
+    }
+    return true;
+}
+
+void WordStore::close() {
+    if (mapped) {
+#ifdef _WIN32
+        UnmapViewOfFile(data);
+#else
+        munmap(const_cast<char*>(data), dataSize);
+#endif
+        mapped = false;
+    }
+#ifdef _WIN32
+    if (mappingHandle != nullptr) {
+        CloseHandle(mappingHandle);
+        mappingHandle = nullptr;
+    }
+    if (fileHandle != INVALID_HANDLE_VALUE) {
+        CloseHandle(fileHandle);
+        fileHandle = INVALID_HANDLE_VALUE;
+    }
+#endif
+    ownedImage.clear();
+    ownedImage.shrink_to_fit();
+    data = nullptr;
+    dataSize = 0;
+}
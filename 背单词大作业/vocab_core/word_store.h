@@ -0,0 +1,140 @@
+﻿#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "string_arena.h"
+
+// ---------------- 二进制词库快照 ----------------
+// 文件布局: [文件头][单词条目 × wordCount][字符串表]
+// 条目只保存字符串表中的偏移和长度，启动时无需解析JSON，也不构建DOM。
+// 每个条目还记录单词对象在 words.json 中的位置，短语等详细信息用到时再去源文件读取。
+// 所有整数按小端序存储（与目标平台 x86/x64 一致）。
+struct SnapshotHeader {
+    char magic[4];            // "WLIB"
+    uint32_t version;         // 格式版本，不一致时视为无效快照
+    uint32_t wordCount;       // 单词条目数
+    uint32_t stringTableSize; // 字符串表字节数
+    uint64_t sourceSize;      // 生成快照时 words.json 的大小
+    int64_t sourceTime;       // 生成快照时 words.json 的修改时间
+};
+
+struct SnapshotEntry {
+    uint32_t wordOffset;      // 单词在字符串表中的偏移
+    uint32_t wordLength;
+    uint32_t meaningOffset;   // 释义在字符串表中的偏移
+    uint32_t meaningLength;
+    uint32_t familiarity;
+    uint32_t sourceLength;    // 单词对象在 words.json 中的字节数，0 表示没有源文件位置
+    uint64_t sourceOffset;    // 单词对象在 words.json 中的起始偏移
+};
+
+static_assert(sizeof(SnapshotHeader) == 32, "快照文件头布局不可改变");
+static_assert(sizeof(SnapshotEntry) == 32, "快照条目布局不可改变");
+
+// 读取文件的大小和修改时间，用于判断快照是否过期
+bool getFileStamp(const char* path, uint64_t& size, int64_t& time);
+
+// 快照构建器：逐个追加单词，最后生成完整的快照镜像。
+// 字符串写入同一个 StringArena，重复的释义默认只保存一份。
+class SnapshotBuilder {
+private:
+    std::vector<SnapshotEntry> entries;
+    StringArena stringTable;
+    bool internMeanings;
+    size_t entryAllocations; // entries 的扩容次数
+
+public:
+    explicit SnapshotBuilder(bool internMeanings = true) : internMeanings(internMeanings), entryAllocations(0) {}
+
+    void reserve(size_t wordCount, size_t stringBytes);
+    void add(std::string_view word, std::string_view meaning, int familiarity,
+        uint64_t sourceOffset = 0, uint32_t sourceLength = 0);
+    size_t size() const { return entries.size(); }
+
+    // 按顺序追加另一个构建器中的全部单词（释义照常去重），用于合并并行解析的分块
+    void appendFrom(const SnapshotBuilder& other);
+
+    // 构建过程中的内存分配次数（条目数组和字符串区的扩容）
+    size_t allocationCount() const { return entryAllocations + stringTable.allocationCount(); }
+    size_t stringBytes() const { return stringTable.size(); }
+    size_t sharedMeanings() const { return stringTable.reuseCount(); }
+    size_t bytesSaved() const { return stringTable.bytesSaved(); }
+
+    // 生成快照镜像，sourceSize/sourceTime 记录源文件的状态
+    std::vector<char> finish(uint64_t sourceSize = 0, int64_t sourceTime = 0) const;
+};
+
+// 只读单词存储：把快照文件映射进内存，按下标返回字符串视图。
+// 映射页由系统按需调入且可与其他进程共享，打开大词库几乎不占私有内存。
+// 没有快照文件时（例如刚解析完JSON），也可以接管一份内存中的快照镜像。
+class WordStore {
+private:
+    const char* data;
+    size_t dataSize;
+    std::vector<char> ownedImage; // 接管的内存镜像（非映射模式）
+    bool mapped;
+#ifdef _WIN32
+    void* fileHandle;
+    void* mappingHandle;
+#endif
+
+    const SnapshotHeader& header() const {
+        return *reinterpret_cast<const SnapshotHeader*>(data);
+    }
+
+    const SnapshotEntry& entry(size_t index) const {
+        return reinterpret_cast<const SnapshotEntry*>(data + sizeof(SnapshotHeader))[index];
+    }
+
+    const char* stringTable() const {
+        return data + sizeof(SnapshotHeader) + header().wordCount * sizeof(SnapshotEntry);
+    }
+
+    bool validate() const;
+
+public:
+    WordStore();
+    ~WordStore() { close(); }
+
+    WordStore(const WordStore&) = delete;
+    WordStore& operator=(const WordStore&) = delete;
+
+    // 映射快照文件；文件不存在或格式无效时返回 false
+    bool open(const char* path);
+
+    // 接管一份内存中的快照镜像
+    bool adopt(std::vector<char>&& image);
+
+    void close();
+
+    bool isOpen() const { return data != nullptr; }
+    size_t size() const { return isOpen() ? header().wordCount : 0; }
+
+    uint64_t sourceSize() const { return header().sourceSize; }
+    int64_t sourceTime() const { return header().sourceTime; }
+
+    // 原始快照字节，用于把内存镜像写回磁盘
+    const char* bytes() const { return data; }
+    size_t byteSize() const { return dataSize; }
+
+    std::string_view word(size_t index) const {
+        const SnapshotEntry& e = entry(index);
+        return std::string_view(stringTable() + e.wordOffset, e.wordLength);
+    }
+
+    std::string_view meaning(size_t index) const {
+        const SnapshotEntry& e = entry(index);
+        return std::string_view(stringTable() + e.meaningOffset, e.meaningLength);
+    }
+
+    int familiarity(size_t index) const {
+        return static_cast<int>(entry(index).familiarity);
+    }
+
+    uint64_t sourceOffset(size_t index) const { return entry(index).sourceOffset; }
+    uint32_t sourceLength(size_t index) const { return entry(index).sourceLength; }
+};
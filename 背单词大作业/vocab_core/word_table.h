@@ -0,0 +1,69 @@
+﻿#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <string_view>
+#include <vector>
+
+#include "word_store.h"
+
+// 单词状态字节：低 2 位为熟悉度（0-3），第 2 位为是否已学习
+const uint8_t STATUS_FAMILIARITY_MASK = 0x03;
+const uint8_t STATUS_LEARNED = 0x04;
+
+inline uint8_t packStatus(int familiarity, bool learned) {
+    return static_cast<uint8_t>((familiarity & STATUS_FAMILIARITY_MASK) | (learned ? STATUS_LEARNED : 0));
+}
+
+inline int statusFamiliarity(uint8_t status) { return status & STATUS_FAMILIARITY_MASK; }
+inline bool statusLearned(uint8_t status) { return (status & STATUS_LEARNED) != 0; }
+
+// 熟悉度对应的"已学习"标记：一般和熟悉的单词需要复习；非常熟悉的单词算作学完，
+// 和未学习的单词一样不进入已学习列表、复习抽样和复习队列
+inline bool familiarityLearned(int familiarity) { return familiarity > 0 && familiarity < 3; }
+
+// 按列存放的单词表：学习状态是一个紧凑的字节数组，字符串留在 WordStore 的字符串表中。
+// 统计和筛选只扫描状态数组，每个单词 1 字节，不会把字符串带进缓存。
+class WordTable {
+private:
+    const WordStore* store;       // 单词和释义字符串
+    std::vector<uint8_t> status;  // 每个单词的状态字节
+
+public:
+    WordTable() : store(nullptr) {}
+
+    // 绑定字符串存储，状态按快照中的熟悉度初始化（已学习标记见 familiarityLearned）
+    void attach(const WordStore& source) {
+        store = &source;
+        status.resize(source.size());
+        for (size_t i = 0; i < status.size(); i++) {
+            int familiarity = source.familiarity(i);
+            status[i] = packStatus(familiarity, familiarityLearned(familiarity));
+        }
+    }
+
+    size_t size() const { return status.size(); }
+
+    std::string_view word(size_t index) const { return store->word(index); }
+    std::string_view meaning(size_t index) const { return store->meaning(index); }
+
+    uint8_t statusOf(size_t index) const { return status[index]; }
+    int familiarity(size_t index) const { return statusFamiliarity(status[index]); }
+    bool learned(size_t index) const { return statusLearned(status[index]); }
+
+    void set(size_t index, int familiarity, bool learned) {
+        status[index] = packStatus(familiarity, learned);
+    }
+
+    const std::vector<uint8_t>& statuses() const { return status; }
+
+    size_t memoryBytes() const { return status.capacity(); }
+
+    // 统计每种熟悉度的单词数，只读取状态数组
+    void countByFamiliarity(size_t counts[4]) const {
+        counts[0] = counts[1] = counts[2] = counts[3] = 0;
+        for (uint8_t s : status) {
+            counts[s & STATUS_FAMILIARITY_MASK]++;
+        }
+    }
+};
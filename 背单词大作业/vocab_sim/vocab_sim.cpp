@@ -0,0 +1,349 @@
+﻿// 无界面的学习者模拟器：不打开 EasyX 窗口，用合成的学习者反复调用单词库的选词和评分接口，
+// 用于测量调度吞吐量和比较不同的复习策略。
+//
+// 每个学习者有一个独立的 WordLibrary，按天学习：每天做固定次数的操作，每次操作
+//   1. 按策略选一张卡片：
+//        random - 按比例调用 getRandomUnlearnedWord / getRandomLearnedWord（加权随机抽样）
+//        sm2    - 先取 getNextDueWord 到期的单词，没有到期的再学新词
+//   2. 由遗忘模型决定学习者是否还记得，并换算成 0-2 的评分（"非常熟悉"会让单词永久
+//      离开复习，是学习者的主动选择而不是回忆的结果，模拟中不使用）
+//   3. 调用 updateWordStatus 记录评分
+// 遗忘模型：记忆强度 S（秒），间隔 t 后记得的概率为 exp(-t / S)；
+// 记得时 S 乘以增长系数，忘记时 S 回到初始值。
+// 每天从未学习列表取词（包括忘记后回到未学习列表的单词）的次数不超过新词上限。
+// 学习者分配到多个线程上并行模拟，结果摘要输出到标准错误，JSON 输出到标准输出。
+// 吞吐量只按复习循环的用时计算，不包括每个学习者加载词库、建立索引的准备时间。
+//
+// 参数：
+//   --deck 路径          使用真实词库（默认生成 --words 个合成单词）
+//   --words N            合成单词数（默认 4000）
+//   --learners N         学习者人数（默认 256）
+//   --days N             模拟天数（默认 60）
+//   --reviews-per-day N  每人每天的操作次数（默认 200）
+//   --new-ratio R        每天新词占操作次数的比例上限（默认 0.2）
+//   --policy P           random、sm2 或 both（默认 both）
+//   --initial-hours H    新学单词的初始记忆强度，小时（默认 96）
+//   --growth G           每次记得后记忆强度的增长系数（默认 3）
+//   --threads N          线程数（默认 0，自动）
+//   --seed N             随机种子（默认 1）
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <iostream>
+#include <random>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "json.hpp"
+#include "word_library.h"
+
+using json = nlohmann::ordered_json;
+
+const int64_t SECONDS_PER_DAY = 24 * 60 * 60;
+const int64_t SECONDS_PER_CARD = 30;        // 每张卡片花费的模拟时间
+const int64_t SIMULATION_START = 1700000000; // 模拟开始的时间戳（任意固定值，保证结果可重复）
+
+enum class Policy { Random, Sm2 };
+
+static const char* policyName(Policy policy) {
+    return policy == Policy::Random ? "random" : "sm2";
+}
+
+struct SimConfig {
+    size_t learners = 256;
+    int days = 60;
+    int reviewsPerDay = 200;
+    double newRatio = 0.2;
+    double initialStrength = 96.0 * 60 * 60; // 秒
+    double growth = 3.0;
+    unsigned threads = 0;
+    uint32_t seed = 1;
+};
+
+// 一个学习者（或多个学习者汇总）的统计
+struct SimStats {
+    uint64_t reviews = 0;      // 复习已学过的单词的次数
+    uint64_t newWords = 0;     // 第一次学习的单词数
+    uint64_t recalled = 0;     // 复习时记得的次数
+    uint64_t idle = 0;         // 没有可选卡片而空过的操作次数
+    double expectedKnown = 0;  // 模拟结束时，按遗忘模型期望仍记得的单词数
+    double setupSeconds = 0;   // 加载词库、建立索引的用时
+    double loopSeconds = 0;    // 复习循环的用时
+
+    void add(const SimStats& other) {
+        reviews += other.reviews;
+        newWords += other.newWords;
+        recalled += other.recalled;
+        idle += other.idle;
+        expectedKnown += other.expectedKnown;
+        setupSeconds += other.setupSeconds;
+        loopSeconds += other.loopSeconds;
+    }
+};
+
+// 学习者对每个单词的记忆
+struct Memory {
+    float strength;   // 记忆强度（秒），0 表示还没学过
+    int64_t lastSeen; // 上次看到的时间
+};
+
+// 记得时按回忆的难易（记得的概率）给出 1-2 分，忘记时给 0 分
+static int rateRecall(bool recalled, double probability) {
+    if (!recalled) return 0;
+    return probability < 0.6 ? 1 : 2;
+}
+
+// 模拟一个学习者
+static SimStats simulateLearner(const std::vector<char>& image, const SimConfig& config, Policy policy,
+    uint32_t seed) {
+    auto setupStart = std::chrono::steady_clock::now();
+    WordLibrary library(seed);
+    std::vector<char> copy(image);
+    library.loadFromImage(std::move(copy));
+    auto loopStart = std::chrono::steady_clock::now();
+
+    std::mt19937 gen(seed ^ 0x9E3779B9u);
+    std::uniform_real_distribution<double> uniform(0.0, 1.0);
+    std::vector<Memory> memory(library.size(), Memory{ 0.0f, 0 });
+    const int newPerDay = static_cast<int>(config.reviewsPerDay * config.newRatio);
+
+    SimStats stats;
+    int64_t now = SIMULATION_START;
+    for (int day = 0; day < config.days; day++) {
+        now = SIMULATION_START + day * SECONDS_PER_DAY;
+        int newToday = 0;
+
+        // 所有从未学习列表取词的路径都经过这里，保证不超过每天的上限
+        auto pickNew = [&]() {
+            if (newToday >= newPerDay) return -1;
+            int index = library.getRandomUnlearnedWord();
+            if (index >= 0) newToday++;
+            return index;
+        };
+
+        for (int action = 0; action < config.reviewsPerDay; action++, now += SECONDS_PER_CARD) {
+            int wordIndex = -1;
+            if (policy == Policy::Sm2) {
+                wordIndex = library.getNextDueWord(now);
+                if (wordIndex < 0) {
+                    wordIndex = pickNew();
+                }
+            }
+            else {
+                bool wantNew = uniform(gen) < config.newRatio;
+                wordIndex = wantNew ? pickNew() : library.getRandomLearnedWord();
+                if (wordIndex < 0) {
+                    wordIndex = wantNew ? library.getRandomLearnedWord() : pickNew();
+                }
+            }
+            if (wordIndex < 0) {
+                stats.idle++;
+                continue;
+            }
+
+            Memory& m = memory[wordIndex];
+            int rating;
+            if (m.strength == 0.0f) {
+                // 第一次学习：看过答案，评"一般"
+                m.strength = static_cast<float>(config.initialStrength);
+                rating = 1;
+                stats.newWords++;
+            }
+            else {
+                double probability = std::exp(-static_cast<double>(now - m.lastSeen) / m.strength);
+                bool recalled = uniform(gen) < probability;
+                rating = rateRecall(recalled, probability);
+                m.strength = recalled ? static_cast<float>(m.strength * config.growth)
+                    : static_cast<float>(config.initialStrength);
+                stats.reviews++;
+                if (recalled) stats.recalled++;
+            }
+            m.lastSeen = now;
+            library.updateWordStatus(wordIndex, rating, now);
+        }
+    }
+
+    // 结束时每个学过的单词仍被记得的概率之和
+    for (const Memory& m : memory) {
+        if (m.strength > 0.0f) {
+            stats.expectedKnown += std::exp(-static_cast<double>(now - m.lastSeen) / m.strength);
+        }
+    }
+    auto loopEnd = std::chrono::steady_clock::now();
+    stats.setupSeconds = std::chrono::duration<double>(loopStart - setupStart).count();
+    stats.loopSeconds = std::chrono::duration<double>(loopEnd - loopStart).count();
+    return stats;
+}
+
+// 在多个线程上模拟全部学习者
+static json runPolicy(const std::vector<char>& image, const SimConfig& config, Policy policy) {
+    unsigned threadCount = config.threads != 0 ? config.threads : std::max(1u, std::thread::hardware_concurrency());
+    threadCount = static_cast<unsigned>(std::min<size_t>(threadCount, config.learners));
+
+    // 每个线程分别累计自己模拟的学习者的准备和复习用时
+    std::vector<SimStats> results(config.learners);
+    std::vector<SimStats> perThread(threadCount);
+    std::atomic<size_t> nextLearner(0);
+    auto worker = [&](unsigned thread) {
+        size_t i;
+        while ((i = nextLearner.fetch_add(1)) < config.learners) {
+            results[i] = simulateLearner(image, config, policy, config.seed + static_cast<uint32_t>(i));
+            perThread[thread].add(results[i]);
+        }
+    };
+
+    auto startTime = std::chrono::steady_clock::now();
+    std::vector<std::thread> workers;
+    for (unsigned i = 1; i < threadCount; i++) {
+        workers.emplace_back(worker, i);
+    }
+    worker(0);
+    for (std::thread& t : workers) {
+        t.join();
+    }
+    double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - startTime).count();
+
+    SimStats total;
+    for (const SimStats& s : results) {
+        total.add(s);
+    }
+    // 线程并行运行，最慢的线程决定复习部分的实际用时
+    double setupSeconds = 0;
+    double loopSeconds = 0;
+    for (const SimStats& s : perThread) {
+        setupSeconds = std::max(setupSeconds, s.setupSeconds);
+        loopSeconds = std::max(loopSeconds, s.loopSeconds);
+    }
+    uint64_t operations = total.reviews + total.newWords;
+    double recallRate = total.reviews > 0 ? static_cast<double>(total.recalled) / total.reviews : 0.0;
+    double knownPerLearner = total.expectedKnown / config.learners;
+    double opsPerSecond = loopSeconds > 0 ? operations / loopSeconds : 0.0;
+
+    std::fprintf(stderr, "%-6s  %llu 次操作, 复习用时 %.2f s（准备 %.2f s, 总计 %.2f s）, %.2f M 次/s（%u 个线程）\n",
+        policyName(policy), static_cast<unsigned long long>(operations), loopSeconds, setupSeconds, seconds,
+        opsPerSecond / 1e6, threadCount);
+    std::fprintf(stderr, "        新词 %llu, 复习 %llu, 复习时记得 %.1f%%, 空闲 %llu, 结束时平均每人记得 %.1f 个单词\n",
+        static_cast<unsigned long long>(total.newWords), static_cast<unsigned long long>(total.reviews),
+        recallRate * 100.0, static_cast<unsigned long long>(total.idle), knownPerLearner);
+
+    return {
+        { "policy", policyName(policy) },
+        { "threads", threadCount },
+        { "seconds", seconds },
+        { "setup_seconds", setupSeconds },
+        { "loop_seconds", loopSeconds },
+        { "operations", operations },
+        { "operations_per_second", opsPerSecond },
+        { "new_words", total.newWords },
+        { "reviews", total.reviews },
+        { "recall_rate", recallRate },
+        { "idle", total.idle },
+        { "known_words_per_learner", knownPerLearner },
+    };
+}
+
+// 合成词库：只需要单词数量正确，字符串内容不影响调度
+static std::vector<char> syntheticImage(size_t wordCount) {
+    SnapshotBuilder builder;
+    builder.reserve(wordCount, wordCount * 8);
+    for (size_t i = 0; i < wordCount; i++) {
+        builder.add("w" + std::to_string(i), "释义", 0);
+    }
+    return builder.finish();
+}
+
+// 真实词库：加载一次后重新生成镜像，熟悉度全部清零，每个学习者从头开始
+static bool deckImage(const char* path, std::vector<char>& image, size_t& wordCount) {
+    WordLibrary library(1);
+    if (!library.loadFromJSON(path)) {
+        return false;
+    }
+    SnapshotBuilder builder;
+    for (size_t i = 0; i < library.size(); i++) {
+        Word word = library[i];
+        builder.add(word.word, word.meaning, 0);
+    }
+    image = builder.finish();
+    wordCount = library.size();
+    return true;
+}
+
+int main(int argc, char* argv[]) {
+    SimConfig config;
+    const char* deckPath = nullptr;
+    size_t wordCount = 4000;
+    std::string policyArg = "both";
+
+    for (int i = 1; i < argc; i++) {
+        bool hasValue = i + 1 < argc;
+        const char* arg = argv[i];
+        if (std::strcmp(arg, "--deck") == 0 && hasValue) deckPath = argv[++i];
+        else if (std::strcmp(arg, "--words") == 0 && hasValue) wordCount = std::strtoull(argv[++i], nullptr, 10);
+        else if (std::strcmp(arg, "--learners") == 0 && hasValue) config.learners = std::strtoull(argv[++i], nullptr, 10);
+        else if (std::strcmp(arg, "--days") == 0 && hasValue) config.days = std::atoi(argv[++i]);
+        else if (std::strcmp(arg, "--reviews-per-day") == 0 && hasValue) config.reviewsPerDay = std::atoi(argv[++i]);
+        else if (std::strcmp(arg, "--new-ratio") == 0 && hasValue) config.newRatio = std::atof(argv[++i]);
+        else if (std::strcmp(arg, "--policy") == 0 && hasValue) policyArg = argv[++i];
+        else if (std::strcmp(arg, "--initial-hours") == 0 && hasValue) config.initialStrength = std::atof(argv[++i]) * 60 * 60;
+        else if (std::strcmp(arg, "--growth") == 0 && hasValue) config.growth = std::atof(argv[++i]);
+        else if (std::strcmp(arg, "--threads") == 0 && hasValue) config.threads = static_cast<unsigned>(std::strtoul(argv[++i], nullptr, 10));
+        else if (std::strcmp(arg, "--seed") == 0 && hasValue) config.seed = static_cast<uint32_t>(std::strtoul(argv[++i], nullptr, 10));
+        else {
+            std::cerr << "用法: vocab_sim [--deck 路径 | --words N] [--learners N] [--days N] [--reviews-per-day N]\n"
+                "                 [--new-ratio R] [--policy random|sm2|both] [--initial-hours H] [--growth G]\n"
+                "                 [--threads N] [--seed N]" << std::endl;
+            return 2;
+        }
+    }
+
+    std::vector<Policy> policies;
+    if (policyArg == "random" || policyArg == "both") policies.push_back(Policy::Random);
+    if (policyArg == "sm2" || policyArg == "both") policies.push_back(Policy::Sm2);
+    if (policies.empty() || config.learners == 0 || config.days <= 0 || config.reviewsPerDay <= 0 ||
+        config.initialStrength <= 0 || config.growth < 1.0) {
+        std::cerr << "参数无效" << std::endl;
+        return 2;
+    }
+
+    std::vector<char> image;
+    if (deckPath != nullptr) {
+        if (!deckImage(deckPath, image, wordCount)) {
+            return 1;
+        }
+    }
+    else {
+        if (wordCount == 0) {
+            std::cerr << "单词数必须大于 0" << std::endl;
+            return 2;
+        }
+        image = syntheticImage(wordCount);
+    }
+    std::fprintf(stderr, "%zu 个学习者, %d 天, 每天 %d 次操作, 词库 %zu 个单词\n",
+        config.learners, config.days, config.reviewsPerDay, wordCount);
+
+    json runs = json::array();
+    for (Policy policy : policies) {
+        runs.push_back(runPolicy(image, config, policy));
+    }
+
+    json output = {
+        { "simulator", "vocab_sim" },
+        { "words", wordCount },
+        { "learners", config.learners },
+        { "days", config.days },
+        { "reviews_per_day", config.reviewsPerDay },
+        { "new_ratio", config.newRatio },
+        { "initial_hours", config.initialStrength / (60 * 60) },
+        { "growth", config.growth },
+        { "runs", runs },
+    };
+    std::cout << output.dump(2) << std::endl;
+    return 0;
+}
@@ -0,0 +1,664 @@
+﻿// 单词库核心的行为测试：直接调用 vocab_core 的各个组件，和逐个计算的结果比较。
+//   timing_wheel      - 分层时间轮的下放、溢出链表、删除和最早到期时间
+//   weighted_sampler  - 树状数组抽样器的权重更新和抽样分布
+//   review_journal    - 学习进度日志的重放、压缩和代数检查
+//   fuzzy_index       - 编辑距离索引的查找结果
+//   prefix_index      - 前缀索引的范围和精确查找
+//   parallel_parse    - 分块并行解析 words.json 的结果与顺序解析逐字节相同
+//
+// 用法：vocab_tests [测试名]，不带参数时运行全部测试。由 CTest 逐个运行：
+//   ctest --test-dir build
+// 失败的检查输出到标准错误，有失败时返回 1。
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <iterator>
+#include <map>
+#include <random>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+#include "review_journal.h"
+#include "timing_wheel.h"
+#include "weighted_sampler.h"
+#include "word_library.h"
+#include "word_store.h"
+
+static int failures = 0;
+
+#define CHECK(condition)                                                                   \
+    do {                                                                                   \
+        if (!(condition)) {                                                                \
+            std::fprintf(stderr, "%s:%d: 检查失败: %s\n", __FILE__, __LINE__, #condition); \
+            failures++;                                                                    \
+        }                                                                                  \
+    } while (0)
+
+// 每个测试使用自己的临时目录，CTest 并行运行时互不干扰
+static std::filesystem::path makeTempDir(const char* name) {
+    std::filesystem::path dir = std::filesystem::temp_directory_path() / (std::string("vocab_tests_") + name);
+    std::error_code ec;
+    std::filesystem::remove_all(dir, ec);
+    std::filesystem::create_directories(dir);
+    return dir;
+}
+
+static std::vector<char> readFile(const std::filesystem::path& path) {
+    std::ifstream in(path, std::ios::binary);
+    return std::vector<char>(std::istreambuf_iterator<char>(in), std::istreambuf_iterator<char>());
+}
+
+// ASCII 字母折叠成小写，与索引的比较规则相同
+static std::string folded(std::string_view text) {
+    std::string result(text);
+    for (char& c : result) {
+        if (c >= 'A' && c <= 'Z') c = static_cast<char>(c + ('a' - 'A'));
+    }
+    return result;
+}
+
+// ---------------- timing_wheel ----------------
+
+const int64_t WHEEL_RESOLUTION = 60 * 60;
+
+static int64_t tickOf(int64_t time) {
+    int64_t tick = time / WHEEL_RESOLUTION;
+    if (time < 0 && tick * WHEEL_RESOLUTION != time) tick--;
+    return tick;
+}
+
+// 与时间轮并行维护一份 id -> 到期时间的表，每次推进时钟后比较取出的元素和剩下的最早时间
+static void testTimingWheel() {
+    const int capacity = 3000;
+    // 到期时间覆盖四种位置：第 0 层（64 小时内）、第 1 层（约半年内）、第 2 层（约 30 年内）和溢出链表
+    const int64_t spans[] = { 64 * WHEEL_RESOLUTION, 4096 * WHEEL_RESOLUTION, 262144 * WHEEL_RESOLUTION,
+        600000 * WHEEL_RESOLUTION };
+    std::mt19937_64 gen(12);
+
+    TimingWheel wheel(WHEEL_RESOLUTION);
+    int64_t now = 1700000000;
+    wheel.reset(capacity, now);
+    std::map<int, int64_t> expected;
+
+    auto insert = [&](int id) {
+        int64_t due = now + static_cast<int64_t>(gen() % static_cast<uint64_t>(spans[gen() % 4]));
+        bool stored = wheel.insert(id, due);
+        CHECK(stored == (tickOf(due) > tickOf(now)));
+        if (stored) expected[id] = due;
+        else expected.erase(id);
+    };
+
+    for (int id = 0; id < capacity; id++) {
+        insert(id);
+    }
+    // 删除和重新插入一部分，覆盖从链表中间摘下元素的情况
+    for (int i = 0; i < capacity / 4; i++) {
+        int id = static_cast<int>(gen() % capacity);
+        if (gen() % 2 == 0) {
+            wheel.erase(id);
+            expected.erase(id);
+        }
+        else {
+            insert(id);
+        }
+    }
+    CHECK(wheel.size() == expected.size());
+
+    std::vector<int> expired;
+    int steps = 0;
+    while (!expected.empty() && steps < 100000) {
+        steps++;
+        // 多数时候走几个刻度，偶尔一次跨过很长的时间，经过多次高层下放
+        uint64_t choice = gen() % 100;
+        int64_t jump = choice < 80 ? static_cast<int64_t>(gen() % 5) * WHEEL_RESOLUTION + static_cast<int64_t>(gen() % 3600)
+            : choice < 97 ? static_cast<int64_t>(gen() % 2000) * WHEEL_RESOLUTION
+            : static_cast<int64_t>(gen() % 300000) * WHEEL_RESOLUTION;
+        now += jump;
+
+        expired.clear();
+        wheel.advance(now, expired);
+        std::vector<int> due;
+        for (auto it = expected.begin(); it != expected.end();) {
+            if (tickOf(it->second) <= tickOf(now)) {
+                due.push_back(it->first);
+                it = expected.erase(it);
+            }
+            else {
+                ++it;
+            }
+        }
+        std::sort(expired.begin(), expired.end());
+        CHECK(expired == due);
+        for (int id : expired) {
+            CHECK(!wheel.contains(id));
+        }
+        CHECK(wheel.size() == expected.size());
+
+        int64_t earliest = -1;
+        for (const auto& item : expected) {
+            if (earliest < 0 || item.second < earliest) earliest = item.second;
+        }
+        CHECK(wheel.earliest() == earliest);
+
+        // 时钟走到任意位置后继续插入，一部分是刚取出的元素
+        if (gen() % 4 == 0) {
+            for (int i = 0; i < 20; i++) {
+                insert(static_cast<int>(gen() % capacity));
+            }
+            CHECK(wheel.size() == expected.size());
+        }
+    }
+    CHECK(expected.empty());
+}
+
+// ---------------- weighted_sampler ----------------
+
+static void checkSamplerDistribution(const WeightedSampler& sampler, const std::vector<int>& weights, std::mt19937& gen) {
+    int64_t total = 0;
+    for (int w : weights) total += w;
+    CHECK(sampler.totalWeight() == total);
+    if (total == 0) {
+        CHECK(sampler.sample(gen) == -1);
+        return;
+    }
+
+    const int draws = 200000;
+    std::vector<int> counts(weights.size());
+    for (int i = 0; i < draws; i++) {
+        int index = sampler.sample(gen);
+        CHECK(index >= 0 && index < static_cast<int>(weights.size()));
+        if (index < 0 || index >= static_cast<int>(weights.size())) return;
+        counts[index]++;
+    }
+    for (size_t i = 0; i < weights.size(); i++) {
+        if (weights[i] == 0) {
+            CHECK(counts[i] == 0);
+            continue;
+        }
+        // 二项分布的 6 倍标准差以内（随机种子固定，结果可重复）
+        double p = static_cast<double>(weights[i]) / static_cast<double>(total);
+        double mean = p * draws;
+        double sigma = std::sqrt(draws * p * (1 - p));
+        CHECK(std::abs(counts[i] - mean) <= 6 * sigma + 1);
+    }
+}
+
+static void testWeightedSampler() {
+    std::mt19937 gen(34);
+    // 元素个数包括 1、2 的幂和不是 2 的幂的情况
+    const size_t sizes[] = { 1, 2, 7, 16, 33 };
+    for (size_t size : sizes) {
+        std::vector<int> weights(size);
+        for (int& w : weights) w = static_cast<int>(gen() % 4);
+        WeightedSampler sampler;
+        sampler.build(weights);
+        checkSamplerDistribution(sampler, weights, gen);
+
+        // 逐个修改权重，包括改成 0 和从 0 改回来
+        for (int round = 0; round < 3; round++) {
+            for (size_t i = 0; i < size; i++) {
+                if (gen() % 2 == 0) {
+                    weights[i] = static_cast<int>(gen() % 5);
+                    sampler.set(i, weights[i]);
+                }
+            }
+            checkSamplerDistribution(sampler, weights, gen);
+        }
+
+        for (size_t i = 0; i < size; i++) {
+            weights[i] = 0;
+            sampler.set(i, 0);
+        }
+        checkSamplerDistribution(sampler, weights, gen);
+
+        weights[size - 1] = 3;
+        sampler.set(size - 1, 3);
+        checkSamplerDistribution(sampler, weights, gen);
+    }
+}
+
+// ---------------- review_journal ----------------
+
+const uint32_t JOURNAL_WORDS = 200;
+const uint64_t JOURNAL_HASH = 0x1234567890abcdefULL;
+
+static ProgressState emptyProgress() {
+    ProgressState progress;
+    progress.familiarity.assign(JOURNAL_WORDS, 0);
+    progress.schedules.assign(JOURNAL_WORDS, CardSchedule());
+    return progress;
+}
+
+static bool sameProgress(const ProgressState& a, const ProgressState& b) {
+    if (a.familiarity != b.familiarity || a.schedules.size() != b.schedules.size()) return false;
+    for (size_t i = 0; i < a.schedules.size(); i++) {
+        const CardSchedule& x = a.schedules[i];
+        const CardSchedule& y = b.schedules[i];
+        if (x.due != y.due || x.interval != y.interval || x.ease != y.ease || x.repetitions != y.repetitions) {
+            return false;
+        }
+    }
+    return true;
+}
+
+// 打开日志得到的进度（打开后立即关闭）
+static ProgressState reopen(const std::filesystem::path& journal, const std::filesystem::path& snapshot) {
+    ProgressState progress = emptyProgress();
+    ReviewJournal reader;
+    CHECK(reader.open(journal.string().c_str(), snapshot.string().c_str(), JOURNAL_HASH, progress));
+    reader.close();
+    return progress;
+}
+
+static ProgressFileHeader readHeader(const std::filesystem::path& path) {
+    ProgressFileHeader h;
+    std::memset(&h, 0, sizeof(h));
+    std::ifstream in(path, std::ios::binary);
+    in.read(reinterpret_cast<char*>(&h), sizeof(h));
+    return h;
+}
+
+static JournalRecord randomRecord(std::mt19937& gen, int64_t& clock) {
+    clock += 1 + static_cast<int64_t>(gen() % 600);
+    JournalRecord r;
+    r.wordIndex = static_cast<uint32_t>(gen() % JOURNAL_WORDS);
+    r.familiarity = static_cast<uint32_t>(gen() % 4);
+    r.timestamp = clock;
+    return r;
+}
+
+static void testReviewJournal() {
+    std::filesystem::path dir = makeTempDir("review_journal");
+    std::filesystem::path journal = dir / "progress.journal";
+    std::filesystem::path snapshot = dir / "progress.bin";
+    std::mt19937 gen(56);
+    int64_t clock = 1700000000;
+    ProgressState expected = emptyProgress();
+
+    // 第一次：只有日志，重新打开后按顺序重放
+    {
+        ProgressState progress = emptyProgress();
+        ReviewJournal writer;
+        CHECK(writer.open(journal.string().c_str(), snapshot.string().c_str(), JOURNAL_HASH, progress));
+        for (int i = 0; i < 500; i++) {
+            JournalRecord r = randomRecord(gen, clock);
+            writer.append(static_cast<int>(r.wordIndex), static_cast<int>(r.familiarity), r.timestamp);
+            expected.apply(r);
+        }
+        writer.close();
+    }
+    CHECK(!std::filesystem::exists(snapshot));
+    CHECK(sameProgress(reopen(journal, snapshot), expected));
+
+    // 末尾写了一半的记录被截掉，不影响已有的记录
+    {
+        std::ofstream out(journal, std::ios::binary | std::ios::app);
+        out.write("\x01\x02\x03\x04\x05", 5);
+    }
+    CHECK(sameProgress(reopen(journal, snapshot), expected));
+    CHECK((std::filesystem::file_size(journal) - sizeof(ProgressFileHeader)) % sizeof(JournalRecord) == 0);
+
+    // 第二次：记录数超过压缩阈值，进度写成快照并换一个新日志
+    {
+        ProgressState progress = emptyProgress();
+        ReviewJournal writer;
+        CHECK(writer.open(journal.string().c_str(), snapshot.string().c_str(), JOURNAL_HASH, progress));
+        CHECK(sameProgress(progress, expected));
+        for (int i = 0; i < 20000; i++) {
+            JournalRecord r = randomRecord(gen, clock);
+            writer.append(static_cast<int>(r.wordIndex), static_cast<int>(r.familiarity), r.timestamp);
+            expected.apply(r);
+        }
+        writer.close();
+    }
+    CHECK(std::filesystem::exists(snapshot));
+    ProgressFileHeader snapshotHeader = readHeader(snapshot);
+    ProgressFileHeader journalHeader = readHeader(journal);
+    CHECK(snapshotHeader.generation >= 1);
+    CHECK(journalHeader.generation == snapshotHeader.generation + 1);
+    CHECK(sameProgress(reopen(journal, snapshot), expected));
+
+    // 压缩之后写入的记录留在新日志中（有多少取决于后台线程的批次）。
+    // 删掉新日志后只按快照恢复，再补上新日志中的记录，应当得到同样的进度
+    std::vector<char> tail = readFile(journal);
+    std::filesystem::remove(journal);
+    ProgressState fromSnapshot = reopen(journal, snapshot);
+    ProgressState replayed = fromSnapshot;
+    size_t tailRecords = (tail.size() - sizeof(ProgressFileHeader)) / sizeof(JournalRecord);
+    for (size_t i = 0; i < tailRecords; i++) {
+        JournalRecord r;
+        std::memcpy(&r, tail.data() + sizeof(ProgressFileHeader) + i * sizeof(r), sizeof(r));
+        replayed.apply(r);
+    }
+    CHECK(sameProgress(replayed, expected));
+    // 删掉的日志中的记录已经丢失，之后以快照中的进度为准
+    expected = fromSnapshot;
+    CHECK(sameProgress(reopen(journal, snapshot), expected));
+
+    // 模拟快照写完、换新日志前退出：留下的旧日志代数不超过快照，记录已包含在快照中，
+    // 不能再重放一次
+    {
+        ProgressFileHeader h = readHeader(journal);
+        h.generation = snapshotHeader.generation;
+        std::ofstream out(journal, std::ios::binary | std::ios::trunc);
+        out.write(reinterpret_cast<const char*>(&h), sizeof(h));
+        for (int i = 0; i < 100; i++) {
+            int64_t staleClock = clock;
+            JournalRecord r = randomRecord(gen, staleClock);
+            out.write(reinterpret_cast<const char*>(&r), sizeof(r));
+        }
+    }
+    CHECK(sameProgress(reopen(journal, snapshot), expected));
+    // 跳过的旧日志被换成了新一代的空日志
+    CHECK(readHeader(journal).generation == snapshotHeader.generation + 1);
+    CHECK(std::filesystem::file_size(journal) == sizeof(ProgressFileHeader));
+    CHECK(sameProgress(reopen(journal, snapshot), expected));
+
+    // 代数在快照之后的日志照常重放
+    {
+        ProgressState progress = emptyProgress();
+        ReviewJournal writer;
+        CHECK(writer.open(journal.string().c_str(), snapshot.string().c_str(), JOURNAL_HASH, progress));
+        for (int i = 0; i < 50; i++) {
+            JournalRecord r = randomRecord(gen, clock);
+            writer.append(static_cast<int>(r.wordIndex), static_cast<int>(r.familiarity), r.timestamp);
+            expected.apply(r);
+        }
+        writer.close();
+    }
+    CHECK(sameProgress(reopen(journal, snapshot), expected));
+
+    // 属于其他词库的日志备份后忽略
+    {
+        ProgressFileHeader h = readHeader(journal);
+        h.libraryHash ^= 1;
+        std::fstream out(journal, std::ios::binary | std::ios::in | std::ios::out);
+        out.write(reinterpret_cast<const char*>(&h), sizeof(h));
+    }
+    ProgressState withoutJournal = reopen(journal, snapshot);
+    CHECK(std::filesystem::exists(dir / "progress.journal.bak"));
+    CHECK(readHeader(journal).libraryHash == JOURNAL_HASH);
+    CHECK(sameProgress(withoutJournal, fromSnapshot));
+
+    std::error_code ec;
+    std::filesystem::remove_all(dir, ec);
+}
+
+// ---------------- fuzzy_index / prefix_index ----------------
+
+// 合成词库：短单词多，字母表小，容易出现拼写相近和前缀相同的单词；
+// 包括大小写不同的重复单词和 UTF-8 字符
+static void buildIndexLibrary(WordLibrary& library, std::vector<std::string>& words) {
+    std::mt19937 gen(78);
+    words.clear();
+    for (int i = 0; i < 3000; i++) {
+        std::string word;
+        int length = 1 + static_cast<int>(gen() % 10);
+        for (int k = 0; k < length; k++) {
+            char c = static_cast<char>('a' + gen() % 6);
+            if (gen() % 8 == 0) c = static_cast<char>(c - ('a' - 'A'));
+            word += c;
+        }
+        if (gen() % 50 == 0) word += "\xC3\xA9"; // é
+        words.push_back(word);
+    }
+    words.push_back("Abc");
+    words.push_back("abc");
+    words.push_back("ABC");
+
+    SnapshotBuilder builder;
+    for (const std::string& word : words) {
+        builder.add(word, "释义", 0);
+    }
+    CHECK(library.loadFromImage(builder.finish()));
+    CHECK(library.size() == words.size());
+}
+
+// 折叠大小写后的 Levenshtein 距离
+static int editDistance(std::string_view a, std::string_view b) {
+    std::string x = folded(a);
+    std::string y = folded(b);
+    std::vector<int> row(y.size() + 1);
+    for (size_t j = 0; j <= y.size(); j++) row[j] = static_cast<int>(j);
+    for (size_t i = 1; i <= x.size(); i++) {
+        int diagonal = row[0];
+        row[0] = static_cast<int>(i);
+        for (size_t j = 1; j <= y.size(); j++) {
+            int above = row[j];
+            row[j] = std::min({ above + 1, row[j - 1] + 1, diagonal + (x[i - 1] == y[j - 1] ? 0 : 1) });
+            diagonal = above;
+        }
+    }
+    return row[y.size()];
+}
+
+static void testFuzzyIndex() {
+    WordLibrary library(1);
+    std::vector<std::string> words;
+    buildIndexLibrary(library, words);
+    std::mt19937 gen(90);
+
+    std::vector<std::string> queries = { "abc", "ABCD", "fed", "a", "abcdefabcd", "\xC3\xA9" };
+    for (int i = 0; i < 150; i++) {
+        // 一半是词库中单词的变形，一半是随机串
+        std::string query = words[gen() % words.size()];
+        if (gen() % 2 == 0) {
+            query.clear();
+            int length = 1 + static_cast<int>(gen() % 12);
+            for (int k = 0; k < length; k++) query += static_cast<char>('a' + gen() % 7);
+        }
+        else if (!query.empty()) {
+            query[gen() % query.size()] = static_cast<char>('a' + gen() % 7);
+        }
+        queries.push_back(query);
+    }
+
+    std::vector<FuzzyMatch> results;
+    for (const std::string& query : queries) {
+        for (int k = 0; k <= 3; k++) {
+            std::vector<std::pair<int, int>> expected; // (距离, 下标)
+            for (size_t i = 0; i < words.size(); i++) {
+                int d = editDistance(query, words[i]);
+                if (d <= k) expected.push_back({ d, static_cast<int>(i) });
+            }
+            std::sort(expected.begin(), expected.end());
+
+            const size_t limits[] = { words.size(), 5 };
+            for (size_t limit : limits) {
+                size_t total = library.searchSimilar(query, k, limit, results);
+                CHECK(total == expected.size());
+                CHECK(results.size() == std::min(limit, expected.size()));
+                for (size_t i = 0; i < results.size() && i < expected.size(); i++) {
+                    CHECK(results[i].distance == expected[i].first);
+                    CHECK(results[i].index == expected[i].second);
+                }
+            }
+        }
+    }
+
+    // 空查询和超过 64 字节的查询不做查找
+    CHECK(library.searchSimilar("", 2, 10, results) == 0);
+    CHECK(library.searchSimilar(std::string(65, 'a'), 2, 10, results) == 0);
+    CHECK(results.empty());
+}
+
+static void testPrefixIndex() {
+    WordLibrary library(1);
+    std::vector<std::string> words;
+    buildIndexLibrary(library, words);
+    std::mt19937 gen(91);
+
+    // 按折叠后的单词排序，相同的按下标
+    std::vector<int> sorted(words.size());
+    for (size_t i = 0; i < sorted.size(); i++) sorted[i] = static_cast<int>(i);
+    std::sort(sorted.begin(), sorted.end(), [&words](int a, int b) {
+        std::string x = folded(words[a]);
+        std::string y = folded(words[b]);
+        return x < y || (x == y && a < b);
+    });
+
+    std::vector<std::string> prefixes = { "", "a", "A", "abc", "ABC", "fff", "g", "zz", "\xC3" };
+    for (int i = 0; i < 200; i++) {
+        std::string prefix = words[gen() % words.size()];
+        prefix.resize(gen() % (prefix.size() + 1));
+        prefixes.push_back(prefix);
+    }
+
+    std::vector<int> results;
+    for (const std::string& prefix : prefixes) {
+        std::string key = folded(prefix);
+        std::vector<int> expected;
+        for (int index : sorted) {
+            if (folded(words[index]).compare(0, key.size(), key) == 0) expected.push_back(index);
+        }
+
+        size_t total = library.searchPrefix(prefix, words.size(), results);
+        CHECK(total == expected.size());
+        CHECK(results == expected);
+
+        total = library.searchPrefix(prefix, 3, results);
+        CHECK(total == expected.size());
+        CHECK(results.size() == std::min<size_t>(3, expected.size()));
+        CHECK(std::equal(results.begin(), results.end(), expected.begin()));
+    }
+
+    // 精确查找返回折叠后相同的单词中下标最小的一个
+    for (int i = 0; i < 300; i++) {
+        std::string query = i % 2 == 0 ? words[gen() % words.size()] : std::string(1 + gen() % 4, 'c');
+        if (gen() % 3 == 0) query = folded(query);
+        int expected = -1;
+        for (size_t k = 0; k < words.size(); k++) {
+            if (folded(words[k]) == folded(query)) {
+                expected = static_cast<int>(k);
+                break;
+            }
+        }
+        CHECK(library.findWord(query) == expected);
+    }
+    CHECK(library.findWord("abc") == library.findWord("ABC"));
+}
+
+// ---------------- parallel_parse ----------------
+
+// 写一个大于并行解析下限（1 MB）的词库。字符串中带有转义的引号、反斜杠和括号，
+// 检验结构扫描不会在字符串内部切块；约 2% 的条目没有 word 字段，解析时跳过
+static void writeDeck(const std::filesystem::path& path, bool pretty, bool bom) {
+    static const char* const meanings[] = {
+        "放弃", "抽象的", "带\\\"引号\\\"的释义", "含 } ] 括号 [ { 的释义", "反斜杠 \\\\ 结尾\\\\", "接受",
+    };
+    std::mt19937 gen(pretty ? 101 : 102);
+    const char* newline = pretty ? "\n" : "";
+    const char* indent = pretty ? "  " : "";
+
+    std::ofstream out(path, std::ios::binary | std::ios::trunc);
+    if (bom) out << "\xEF\xBB\xBF";
+    out << "[" << newline;
+    const int count = 12000;
+    for (int i = 0; i < count; i++) {
+        out << indent << "{";
+        if (gen() % 50 != 0) {
+            out << "\"word\": \"w" << i << "x" << gen() % 1000 << "\", ";
+        }
+        out << "\"translations\": [";
+        int translations = static_cast<int>(gen() % 3);
+        for (int t = 0; t < translations; t++) {
+            out << (t > 0 ? ", " : "") << "{\"translation\": \"" << meanings[gen() % 6] << "\", \"type\": \"n\"}";
+        }
+        out << "]";
+        if (gen() % 2 == 0) out << ", \"familiarity\": " << gen() % 4;
+        if (gen() % 3 == 0) {
+            out << ", \"phrases\": [{\"phrase\": \"a [phrase] {with} \\\"quotes\\\"\", \"translation\": \"短语\"}]";
+        }
+        out << "}" << (i + 1 < count ? "," : "") << newline;
+    }
+    out << "]" << newline;
+}
+
+static void testParallelParse() {
+    std::filesystem::path dir = makeTempDir("parallel_parse");
+    const bool variants[][2] = { { true, false }, { false, true } };
+    for (const auto& variant : variants) {
+        std::filesystem::path deck = dir / "words.json";
+        writeDeck(deck, variant[0], variant[1]);
+        CHECK(std::filesystem::file_size(deck) >= 1024 * 1024);
+        std::vector<char> source = readFile(deck);
+
+        std::vector<char> sequential;
+        const unsigned threadCounts[] = { 1, 2, 4, 16 };
+        for (unsigned threads : threadCounts) {
+            WordLibrary library(1);
+            CHECK(library.loadFromJSON(deck.string().c_str(), threads));
+            if (threads == 1) {
+                CHECK(library.lastLoadStats().chunks == 1);
+            }
+            else {
+                CHECK(library.lastLoadStats().chunks >= 2);
+            }
+
+            // 每个单词记下的位置正好是源文件中它所在的对象
+            for (size_t i = 0; i < library.size(); i++) {
+                uint64_t offset = 0;
+                uint32_t length = 0;
+                CHECK(library.sourceRange(i, offset, length));
+                CHECK(offset + length <= source.size());
+                if (offset + length > source.size() || length < 2) break;
+                std::string_view object(source.data() + offset, length);
+                CHECK(object.front() == '{' && object.back() == '}');
+                std::string key = "\"word\": \"" + std::string(library[i].word) + "\"";
+                CHECK(object.find(key) != std::string_view::npos);
+            }
+
+            std::filesystem::path image = dir / ("words_" + std::to_string(threads) + ".bin");
+            CHECK(library.saveSnapshot(image.string().c_str()));
+            if (threads == 1) {
+                sequential = readFile(image);
+                CHECK(!sequential.empty());
+            }
+            else {
+                CHECK(readFile(image) == sequential);
+            }
+        }
+    }
+
+    std::error_code ec;
+    std::filesystem::remove_all(dir, ec);
+}
+
+// ---------------- 入口 ----------------
+
+struct TestCase {
+    const char* name;
+    void (*run)();
+};
+
+static const TestCase tests[] = {
+    { "timing_wheel", testTimingWheel },
+    { "weighted_sampler", testWeightedSampler },
+    { "review_journal", testReviewJournal },
+    { "fuzzy_index", testFuzzyIndex },
+    { "prefix_index", testPrefixIndex },
+    { "parallel_parse", testParallelParse },
+};
+
+int main(int argc, char** argv) {
+    bool found = false;
+    for (const TestCase& test : tests) {
+        if (argc > 1 && std::strcmp(argv[1], test.name) != 0) continue;
+        found = true;
+        int before = failures;
+        test.run();
+        std::fprintf(stderr, "%-18s %s\n", test.name, failures == before ? "通过" : "失败");
+    }
+    if (!found) {
+        std::fprintf(stderr, "没有名为 %s 的测试\n", argv[1]);
+        return 1;
+    }
+    return failures == 0 ? 0 : 1;
+}
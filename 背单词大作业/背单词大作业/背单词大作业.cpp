@@ -5,22 +5,37 @@
 #include <graphics.h>
 #include <conio.h>
 #include <string>
+#include <string_view>
 #include <vector>
 #include <cstdlib>
 #include <ctime>
 #include <iostream>
 #include <fstream>
+#include <sstream>
 #include <random>
 #include <algorithm>
-#include "json.hpp"
-#include <sstream>
-
-using json = nlohmann::json;
+#include <cstring>
+#include <chrono>
+#include <cwchar>
+#include "word_library.h"
+#include "review_journal.h"
+#include "word_details.h"
+#include "meaning_index.h"
 
 // 窗口大小
 const int WINDOW_WIDTH = 570;
 const int WINDOW_HEIGHT = 650;
 
+// 词库文件路径
+const char* const WORDS_JSON_PATH = "words.json";
+const char* const WORDS_SNAPSHOT_PATH = "words.bin"; // 由 words.json 预编译的二进制快照
+const char* const PROGRESS_JOURNAL_PATH = "progress.journal"; // 学习进度日志（只追加）
+const char* const PROGRESS_SNAPSHOT_PATH = "progress.snap";   // 压缩后的学习进度快照
+const int64_t REVIEW_SKIP_SECONDS = 10 * 60; // 复习时按"下一个"跳过的单词多久后再出现
+
+// 启动时加 --stats 参数才在控制台输出加载、内存、字体和帧数统计（调试用）
+bool showStats = false;
+
 // 更新后的颜色定义
 namespace Colors {
     constexpr COLORREF Background = 0x00F8F9FA;    // 浅灰色背景
@@ -36,12 +51,188 @@ namespace Colors {
     constexpr COLORREF Familiar2 = 0x006CBF84;    // 森林绿
     constexpr COLORREF Subtitle = 0x006C757D;  // 中性灰
     constexpr COLORREF addColor = 0x90EE90;   //薄荷绿
+    constexpr COLORREF DirtyOverlay = 0x000000FF; // 调试用：重绘区域边框（红色）
 }
 
 // 字符串转换函数（提前定义以避免未定义错误）
-std::wstring utf8ToWstring(const std::string& str);
+std::wstring utf8ToWstring(std::string_view str);
+std::string wstringToUtf8(std::wstring_view str);
+
+// 是否为汉字（基本区、扩展 A 区和兼容区，不处理代理对）
+inline bool isHanChar(wchar_t ch) {
+    return (ch >= 0x4E00 && ch <= 0x9FFF) || (ch >= 0x3400 && ch <= 0x4DBF) || (ch >= 0xF900 && ch <= 0xFAFF);
+}
+
+// 预先转换好的宽字符文本，并记住在某个字号下测得的尺寸，
+// 绘制时不再做编码转换，也不分配内存
+struct CachedText {
+    std::wstring text;
+    int fontSize; // 测量尺寸时使用的字号，0 表示尚未测量
+    int width;
+    int height;
+
+    CachedText() : fontSize(0), width(0), height(0) {}
+    explicit CachedText(const wchar_t* str) : text(str), fontSize(0), width(0), height(0) {}
+
+    void assign(std::string_view utf8) {
+        text = utf8ToWstring(utf8);
+        fontSize = 0;
+    }
+
+    void assign(const wchar_t* str) {
+        text = str;
+        fontSize = 0;
+    }
+
+    // 测量文本尺寸（调用前需已用该字号设置字体），同一字号只测量一次
+    void measure(int size) {
+        if (fontSize == size) return;
+        width = textwidth(text.c_str());
+        height = textheight(text.c_str());
+        fontSize = size;
+    }
+
+    // 测量并把过长的文本截短到 maxWidth 以内，末尾加省略号（截短后的结果同样被缓存）
+    void fit(int size, int maxWidth) {
+        measure(size);
+        if (width <= maxWidth) return;
+        while (!text.empty() && textwidth((text + L"…").c_str()) > maxWidth) {
+            text.pop_back();
+        }
+        text += L"…";
+        fontSize = 0;
+        measure(size);
+    }
+};
+
+// 界面字体
+const wchar_t* const UI_FONT_FACE = L"微软雅黑";
+
+// 字体缓存：每种 (字号, 字体名) 的 LOGFONT 只生成一次，并记住窗口当前使用的字体，
+// 请求的字体已经是当前字体时不再调用 settextstyle。同时统计每帧实际切换了几次字体。
+class FontCache {
+private:
+    struct Entry {
+        int size;
+        std::wstring face;
+        LOGFONT font;
+    };
+
+    std::vector<Entry> entries;  // 界面只用到几种字号，线性查找即可
+    int current;                 // 窗口当前字体在 entries 中的下标，-1 表示未知
+    long long switches;          // 实际调用 settextstyle 的次数
+    long long skipped;           // 字体已是当前字体而省去的次数
+    long long frames;
+    int frameSwitches;           // 本帧的切换次数
+    int maxFrameSwitches;
+
+    int find(int size, const wchar_t* face) {
+        for (size_t i = 0; i < entries.size(); i++) {
+            if (entries[i].size == size && entries[i].face == face) return static_cast<int>(i);
+        }
+        // 以当前字体为模板，只改字号和字体名，与 settextstyle(size, 0, face) 效果相同
+        Entry e;
+        e.size = size;
+        e.face = face;
+        gettextstyle(&e.font);
+        e.font.lfHeight = size;
+        e.font.lfWidth = 0;
+        wcsncpy_s(e.font.lfFaceName, face, _TRUNCATE);
+        entries.push_back(e);
+        return static_cast<int>(entries.size() - 1);
+    }
+
+public:
+    FontCache() : current(-1), switches(0), skipped(0), frames(0), frameSwitches(0), maxFrameSwitches(0) {}
+
+    ~FontCache() {
+        if (!showStats || frames == 0) return;
+        std::cout << "字体切换: " << switches << " 次, 平均每帧 " << static_cast<double>(switches) / frames
+            << " 次, 最多 " << maxFrameSwitches << " 次, 省去 " << skipped << " 次, 缓存字体 "
+            << entries.size() << " 种" << std::endl;
+    }
+
+    // 在窗口上选用字体
+    void select(int size, const wchar_t* face = UI_FONT_FACE) {
+        int index = find(size, face);
+        if (index == current) {
+            skipped++;
+            return;
+        }
+        settextstyle(&entries[index].font);
+        current = index;
+        switches++;
+        frameSwitches++;
+    }
+
+    // 取得字体描述，用于在其他绘图设备（如按钮贴图）上设置字体，不改变记录的窗口字体
+    const LOGFONT* get(int size, const wchar_t* face = UI_FONT_FACE) {
+        return &entries[find(size, face)].font;
+    }
+
+    void beginFrame() { frameSwitches = 0; }
+
+    void endFrame() {
+        frames++;
+        if (frameSwitches > maxFrameSwitches) maxFrameSwitches = frameSwitches;
+    }
+};
+
+FontCache fontCache;
+
+// 需要重绘的矩形区域（包含右边和下边）
+struct DirtyRect {
+    int left, top, right, bottom;
+
+    bool overlaps(const DirtyRect& other) const {
+        return left <= other.right && other.left <= right && top <= other.bottom && other.top <= bottom;
+    }
+
+    void merge(const DirtyRect& other) {
+        if (other.left < left) left = other.left;
+        if (other.top < top) top = other.top;
+        if (other.right > right) right = other.right;
+        if (other.bottom > bottom) bottom = other.bottom;
+    }
+};
+
+// 一帧中被重绘的区域。重叠的区域合并成一个，区域太多时退化为它们的外接矩形，
+// 提交时对每个区域各调用一次 FlushBatchDraw
+class DamageTracker {
+private:
+    static const size_t MAX_RECTS = 8;
+    std::vector<DirtyRect> rects;
+
+public:
+    void add(DirtyRect rect) {
+        // 合并后的矩形可能又和其他矩形重叠，所以反复合并直到不再重叠
+        for (size_t i = 0; i < rects.size();) {
+            if (rects[i].overlaps(rect)) {
+                rect.merge(rects[i]);
+                rects.erase(rects.begin() + i);
+                i = 0;
+            }
+            else {
+                i++;
+            }
+        }
+        rects.push_back(rect);
+
+        if (rects.size() > MAX_RECTS) {
+            DirtyRect all = rects.front();
+            for (const DirtyRect& r : rects) all.merge(r);
+            rects.assign(1, all);
+        }
+    }
+
+    void clear() { rects.clear(); }
+    bool empty() const { return rects.empty(); }
+    const std::vector<DirtyRect>& regions() const { return rects; }
+};
 
 // 修改后的按钮基类（增加圆角半径和文本颜色参数）
+// 普通和悬停两种外观各预先绘制到一张 IMAGE 中，每帧只需 putimage 贴图，
+// 文字或颜色改变时才重新绘制
 class Button {
 protected:
     int x, y, width, height;
@@ -50,6 +241,37 @@ protected:
     bool isHovered;
     COLORREF normalColor, hoverColor, textColor;
     int radius;
+    IMAGE sprites[2];      // 0 为普通外观，1 为悬停外观
+    bool spriteValid[2];   // 对应的贴图是否已经绘制
+    bool dirty;            // 外观变化后还没有画到屏幕上
+
+    // 把一种外观绘制到贴图中。按钮都画在窗口背景上，圆角外的部分填背景色
+    void renderSprite(int state) {
+        IMAGE* previous = GetWorkingImage();
+        sprites[state].Resize(width + 1, height + 1);
+        SetWorkingImage(&sprites[state]);
+
+        setbkcolor(Colors::Background);
+        cleardevice();
+        setlinecolor(WHITE);
+        setlinestyle(PS_SOLID, 1);
+        setfillcolor(state == 1 ? hoverColor : normalColor);
+        fillroundrect(0, 0, width, height, radius, radius);
+
+        settextstyle(fontCache.get(33));
+        setbkmode(TRANSPARENT); // 设置背景透明
+        settextcolor(textColor);
+        int textWidth = textwidth(wtext.c_str());
+        int textHeight = textheight(wtext.c_str());
+        outtextxy((width - textWidth) / 2, (height - textHeight) / 2, wtext.c_str());
+
+        SetWorkingImage(previous);
+        spriteValid[state] = true;
+    }
+
+    void invalidate() {
+        spriteValid[0] = spriteValid[1] = false;
+    }
 
 public:
     // 构造函数重载 - 接受窄字符字符串
@@ -62,7 +284,7 @@ public:
         wtext(utf8ToWstring(text)), // 立即转换为宽字符
         isHovered(false), normalColor(normalColor),
         hoverColor(hoverColor), textColor(textColor),
-        radius(radius) {}
+        radius(radius), spriteValid{ false, false }, dirty(true) {}
 
     // 构造函数重载 - 接受宽字符字符串
     Button(int x, int y, int width, int height, const std::wstring& wtext,
@@ -73,215 +295,401 @@ public:
         : x(x), y(y), width(width), height(height), wtext(wtext),
         isHovered(false), normalColor(normalColor),
         hoverColor(hoverColor), textColor(textColor),
-        radius(radius) {}
+        radius(radius), spriteValid{ false, false }, dirty(true) {}
 
     virtual void draw() {
-        // 使用圆角参数绘制按钮
-        setfillcolor(isHovered ? hoverColor : normalColor);
-        fillroundrect(x, y, x + width, y + height, radius, radius);
+        int state = isHovered ? 1 : 0;
+        if (!spriteValid[state]) {
+            renderSprite(state);
+        }
+        putimage(x, y, &sprites[state]);
+        dirty = false;
+    }
 
-        // 设置字体样式
-        settextstyle(33, 0, _T("微软雅黑"));
-        setbkmode(TRANSPARENT); // 设置背景透明
+    // 只在外观变化后重绘，并记录重绘区域。贴图不透明且覆盖整个按钮，不需要先画背景
+    void drawIfDirty(DamageTracker& damage) {
+        if (!dirty) return;
+        draw();
+        damage.add(bounds());
+    }
 
-        // 绘制文字
-        int textWidth = textwidth(wtext.c_str());
-        int textHeight = textheight(wtext.c_str());
-        int textX = x + (width - textWidth) / 2;
-        int textY = y + (height - textHeight) / 2;
+    DirtyRect bounds() const { return DirtyRect{ x, y, x + width, y + height }; }
 
-        // 确保文本颜色可见
-        settextcolor(textColor);
-        outtextxy(textX, textY, wtext.c_str());
+    // 修改文字，贴图在下次绘制时重新生成
+    void setText(const std::string& newText) {
+        if (newText == text) return;
+        text = newText;
+        wtext = utf8ToWstring(newText);
+        invalidate();
+        dirty = true;
+    }
+
+    // 修改颜色，贴图在下次绘制时重新生成
+    void setColors(COLORREF normal, COLORREF hover, COLORREF textCol) {
+        if (normal == normalColor && hover == hoverColor && textCol == textColor) return;
+        normalColor = normal;
+        hoverColor = hover;
+        textColor = textCol;
+        invalidate();
+        dirty = true;
     }
 
     virtual bool isClicked(int mx, int my) {
         return mx >= x && mx <= x + width && my >= y && my <= y + height;
     }
 
-    virtual void checkHover(int mx, int my) {
-        isHovered = (mx >= x && mx <= x + width && my >= y && my <= y + height);
+    // 更新悬停状态，返回状态是否发生变化（变化时才需要重绘）
+    virtual bool checkHover(int mx, int my) {
+        bool hovered = (mx >= x && mx <= x + width && my >= y && my <= y + height);
+        bool changed = hovered != isHovered;
+        isHovered = hovered;
+        dirty |= changed;
+        return changed;
     }
 };
 
-// 单词结构体
-struct Word {
-    std::string word;
-    std::string meaning;
-    int familiarity; // 熟悉度: 0-不熟悉, 1-一般, 2-熟悉，3-非常熟悉
-    bool learned;    // 是否已学习
-
-    Word() : familiarity(0), learned(false) {}
-};
-
 // 全局单词库
-std::vector<Word> wordLibrary;
-std::vector<int> unlearnedWords;
-std::vector<int> learnedWords;
-
-// 随机数生成器
-std::random_device rd;
-std::mt19937 gen(rd());
+WordLibrary wordLibrary;
 
 // 字符串转换函数实现
-std::wstring utf8ToWstring(const std::string& str) {
+std::wstring utf8ToWstring(std::string_view str) {
     if (str.empty()) return L"";
 
-    int len = MultiByteToWideChar(CP_UTF8, 0, str.c_str(), -1, nullptr, 0);
+    int len = MultiByteToWideChar(CP_UTF8, 0, str.data(), static_cast<int>(str.size()), nullptr, 0);
     if (len == 0) return L"";
 
     std::wstring wstr(len, L'\0');
-    MultiByteToWideChar(CP_UTF8, 0, str.c_str(), -1, &wstr[0], len);
+    MultiByteToWideChar(CP_UTF8, 0, str.data(), static_cast<int>(str.size()), &wstr[0], len);
 
     return wstr;
 }
 
-// 从JSON文件加载单词库
-bool loadWordLibraryFromJSON() {
-    try {
-        std::ifstream file("words.json", std::ios::binary);
-        if (!file.is_open()) {
-            throw std::runtime_error("无法打开 words.json 文件");
-        }
-
-        json jsonData;
-        file >> jsonData;
+std::string wstringToUtf8(std::wstring_view str) {
+    if (str.empty()) return "";
 
-        wordLibrary.clear();
-        unlearnedWords.clear();
-        learnedWords.clear();
+    int len = WideCharToMultiByte(CP_UTF8, 0, str.data(), static_cast<int>(str.size()), nullptr, 0, nullptr, nullptr);
+    if (len == 0) return "";
 
-        for (auto& item : jsonData) {
-            Word word;
-            word.word = item["word"].get<std::string>();
+    std::string utf8(len, '\0');
+    WideCharToMultiByte(CP_UTF8, 0, str.data(), static_cast<int>(str.size()), &utf8[0], len, nullptr, nullptr);
 
-            if (item.contains("translations") && !item["translations"].empty()) {
-                word.meaning = item["translations"][0]["translation"].get<std::string>();
-            }
-            else {
-                word.meaning = "暂无翻译";
-            }
+    return utf8;
+}
 
-            // 修复熟悉度判断逻辑
-            word.familiarity = item.contains("familiarity") ? item["familiarity"].get<int>() : 0;
+// 输出单词库的内存占用（快照镜像 + 索引）和平均每个单词的字节数
+void printMemoryUsage() {
+    if (!showStats || wordLibrary.size() == 0) return;
+    MemoryUsage usage = wordLibrary.memoryUsage();
+    size_t total = usage.storeBytes + usage.indexBytes;
+    std::cout << "内存占用: 快照 " << usage.storeBytes << " 字节, 索引 " << usage.indexBytes
+        << " 字节, 每个单词 " << static_cast<double>(total) / wordLibrary.size() << " 字节" << std::endl;
+}
 
-            // 分类单词
-            if (word.familiarity == 0) {
-                word.learned = false;
-                unlearnedWords.push_back(wordLibrary.size());
-            }
-            else if (0 < word.familiarity <= 3) {
-                word.learned = true;
-                learnedWords.push_back(wordLibrary.size());
-            }
+// 从JSON文件流式加载单词库；加 --stats 时输出解析速度和内存分配情况
+bool loadWordLibraryFromJSON() {
+    if (!wordLibrary.loadFromJSON(WORDS_JSON_PATH)) {
+        return false;
+    }
 
-            wordLibrary.push_back(word);
-        }
+    const LoadStats& stats = wordLibrary.lastLoadStats();
+    std::cout << "已加载 " << wordLibrary.size() << " 个单词" << std::endl;
+    std::cout << "未学习: " << wordLibrary.unlearnedCount() << ", 已学习: " << wordLibrary.learnedCount() << std::endl;
+    if (!showStats) return true;
+    if (stats.seconds > 0 && stats.bytes > 0) {
+        std::cout << "解析 " << stats.bytes << " 字节, 用时 " << stats.seconds * 1000.0 << " ms, "
+            << stats.bytes / stats.seconds / (1024.0 * 1024.0) << " MB/s, "
+            << stats.threads << " 个线程, " << stats.chunks << " 块" << std::endl;
+    }
+    std::cout << "字符串表 " << stats.stringBytes << " 字节, " << stats.sharedMeanings << " 个单词复用已有释义, 节省 "
+        << stats.savedBytes << " 字节, 内存分配 " << stats.allocations << " 次" << std::endl;
+    printMemoryUsage();
+    return true;
+}
 
-        std::cout << "已加载 " << wordLibrary.size() << " 个单词" << std::endl;
-        std::cout << "未学习: " << unlearnedWords.size() << ", 已学习: " << learnedWords.size() << std::endl;
+// 加载单词库：优先使用二进制快照，没有可用快照时解析JSON并顺便生成快照
+bool loadWordLibrary() {
+    if (wordLibrary.loadFromSnapshot(WORDS_SNAPSHOT_PATH, WORDS_JSON_PATH)) {
+        std::cout << "已从快照加载 " << wordLibrary.size() << " 个单词" << std::endl;
+        std::cout << "未学习: " << wordLibrary.unlearnedCount() << ", 已学习: " << wordLibrary.learnedCount() << std::endl;
+        printMemoryUsage();
         return true;
     }
-    catch (const std::exception& e) {
-        std::cerr << "加载单词库错误: " << e.what() << std::endl;
+
+    if (!loadWordLibraryFromJSON()) {
         return false;
     }
-}
 
-// 随机选择一个未学习的单词
-int getRandomUnlearnedWord() {
-    if (unlearnedWords.empty()) {
-        return -1; // 没有未学习的单词
+    if (wordLibrary.saveSnapshot(WORDS_SNAPSHOT_PATH)) {
+        std::cout << "已生成词库快照 " << WORDS_SNAPSHOT_PATH << std::endl;
     }
+    return true;
+}
+
+// 全局学习进度日志（全局对象，程序退出时析构函数会写完剩余记录）
+ReviewJournal reviewJournal;
+
+// 单词详细信息（全部释义和短语）的缓存，卡片显示时才从 words.json 读取
+WordDetailsCache wordDetails;
+
+// 释义倒排索引（中译英查找和测验用），第一次用到时才建立
+MeaningIndex meaningIndex;
+bool meaningIndexBuilt = false;
 
-    std::uniform_int_distribution<> dis(0, unlearnedWords.size() - 1);
-    return unlearnedWords[dis(gen)];
+const MeaningIndex& getMeaningIndex() {
+    if (!meaningIndexBuilt) {
+        auto startTime = std::chrono::steady_clock::now();
+        meaningIndex.build(wordLibrary, WORDS_JSON_PATH);
+        meaningIndexBuilt = true;
+        double ms = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - startTime).count();
+        if (showStats) std::cout << "释义索引: " << meaningIndex.termCount() << " 个字词, " << meaningIndex.postingTotal()
+            << " 条记录, 压缩后 " << meaningIndex.postingBytes() << " 字节, 用时 " << ms << " ms" << std::endl;
+    }
+    return meaningIndex;
 }
 
-// 随机选择一个已学习的单词用于复习
-int getRandomLearnedWord() {
-    if (learnedWords.empty()) {
-        return -1; // 没有已学习的单词
+// 读取快照并重放日志，把保存的熟悉度和复习计划恢复到单词库
+void restoreProgress() {
+    auto startTime = std::chrono::steady_clock::now();
+
+    ProgressState progress;
+    progress.familiarity.resize(wordLibrary.size());
+    for (size_t i = 0; i < wordLibrary.size(); i++) {
+        progress.familiarity[i] = static_cast<uint8_t>(wordLibrary[i].familiarity);
     }
 
-    // 过滤掉熟悉度为3的单词
-    std::vector<int> validWords;
-    for (int idx : learnedWords) {
-        if (wordLibrary[idx].familiarity < 3) {
-            validWords.push_back(idx);
-        }
+    if (!reviewJournal.open(PROGRESS_JOURNAL_PATH, PROGRESS_SNAPSHOT_PATH, wordLibrary.computeHash(), progress)) {
+        return;
     }
 
-    if (validWords.empty()) {
-        return -1; // 没有需要复习的单词
+    size_t restored = wordLibrary.applyProgress(progress.familiarity, progress.schedules,
+        static_cast<int64_t>(std::time(nullptr)));
+
+    if (!showStats) return;
+    double ms = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - startTime).count();
+    std::cout << "已恢复 " << restored << " 个单词的学习进度, 用时 " << ms << " ms" << std::endl;
+    std::cout << "复习队列: " << wordLibrary.scheduledCount() << " 个单词" << std::endl;
+
+    size_t counts[4];
+    wordLibrary.countByFamiliarity(counts);
+    std::cout << "熟悉度分布: 不熟悉 " << counts[0] << ", 一般 " << counts[1]
+        << ", 熟悉 " << counts[2] << ", 非常熟悉 " << counts[3] << std::endl;
+}
+
+// 评分：更新单词状态和复习计划，并写入学习进度日志
+void rateWord(int wordIndex, int newFamiliarity) {
+    int64_t now = static_cast<int64_t>(std::time(nullptr));
+    wordLibrary.updateWordStatus(wordIndex, newFamiliarity, now);
+    reviewJournal.append(wordIndex, newFamiliarity, now);
+}
+
+// 距离下次复习的提示文字，例如"下次复习: 3 小时后"
+std::wstring nextReviewMessage() {
+    int64_t due = wordLibrary.nextReviewTime();
+    if (due < 0) {
+        return L"没有需要复习的单词";
+    }
+    int64_t wait = due - static_cast<int64_t>(std::time(nullptr));
+    if (wait < 60 * 60) {
+        return L"下次复习: " + std::to_wstring(wait / 60 + 1) + L" 分钟后";
+    }
+    if (wait < 24 * 60 * 60) {
+        return L"下次复习: " + std::to_wstring(wait / (60 * 60)) + L" 小时后";
     }
+    return L"下次复习: " + std::to_wstring(wait / (24 * 60 * 60)) + L" 天后";
+}
 
-    // 按熟悉度加权随机选择
-    std::vector<int> weightedPool;
-    for (int idx : validWords) {
-        int weight = 3 - wordLibrary[idx].familiarity; // 熟悉度越低权重越高
-        for (int i = 0; i < weight; i++) {
-            weightedPool.push_back(idx);
-        }
+// 帧计数：每处理一批输入消息，要么重绘一帧，要么跳过。
+// 空闲时两者都不增长，说明主循环在阻塞等待而不是空转。
+struct FrameCounter {
+    long long drawn = 0;   // 实际重绘的帧数
+    long long skipped = 0; // 消息未改变界面、跳过重绘的次数
+    long long partial = 0; // 只重绘了变化区域的帧数
+    long long regions = 0; // 局部重绘提交的区域总数
+
+    ~FrameCounter() {
+        if (!showStats) return;
+        std::cout << "绘制帧数: " << drawn << ", 跳过帧数: " << skipped << std::endl;
+        std::cout << "局部重绘: " << partial << " 帧, " << regions << " 个区域" << std::endl;
     }
+};
 
-    std::uniform_int_distribution<> dis(0, weightedPool.size() - 1);
-    return weightedPool[dis(gen)];
-}
+FrameCounter frameCounter;
 
-// 更新单词学习状态
-void updateWordStatus(int wordIndex, int newFamiliarity) {
-    if (wordIndex < 0 || wordIndex >= wordLibrary.size()) {
-        return;
+// 帧耗时分析：用 QueryPerformanceCounter 记录每帧处理输入、绘制和提交（FlushBatchDraw）的耗时，
+// 以及点击熟悉度按钮到下一张卡片提交到窗口的延迟。
+// 按 F10 在右上角显示最近若干帧的平均值；启动时加 --trace 参数则把每帧的数据写入 CSV 文件。
+class FrameProfiler {
+private:
+    struct FrameRecord {
+        double inputMs;
+        double drawMs;
+        double flushMs;
+        double latencyMs; // 这一帧没有响应点击时为负数
+    };
+
+    static const int HISTORY = 60; // 浮层显示最近多少帧的平均值
+
+    double ticksPerMs;
+    int64_t inputStart;
+    int64_t drawStart;
+    int64_t drawEnd;
+    int64_t flushStart;
+    double pendingInputMs; // 上一帧之后累计的输入处理耗时，没有引起重绘的消息也算在内
+    int64_t clickTime;     // 等待显示的点击时刻，0 表示没有
+    FrameRecord history[HISTORY];
+    int historyCount;
+    int historyNext;
+    double lastLatencyMs;
+    long long frameIndex;
+    std::ofstream trace;
+
+    static int64_t now() {
+        LARGE_INTEGER t;
+        QueryPerformanceCounter(&t);
+        return t.QuadPart;
     }
 
-    Word& word = wordLibrary[wordIndex];
-    bool wasLearned = word.learned;
-    word.familiarity = newFamiliarity;
+    double elapsedMs(int64_t from, int64_t to) const {
+        return static_cast<double>(to - from) / ticksPerMs;
+    }
 
-    // 从现有列表中移除
-    auto it_un = std::find(unlearnedWords.begin(), unlearnedWords.end(), wordIndex);
-    if (it_un != unlearnedWords.end()) {
-        unlearnedWords.erase(it_un);
+public:
+    static const int OVERLAY_WIDTH = 220;
+    static const int OVERLAY_HEIGHT = 76;
+
+    FrameProfiler() : inputStart(0), drawStart(0), drawEnd(0), flushStart(0), pendingInputMs(0), clickTime(0),
+        history(), historyCount(0), historyNext(0), lastLatencyMs(-1), frameIndex(0) {
+        LARGE_INTEGER frequency;
+        QueryPerformanceFrequency(&frequency);
+        ticksPerMs = static_cast<double>(frequency.QuadPart) / 1000.0;
     }
 
-    auto it_l = std::find(learnedWords.begin(), learnedWords.end(), wordIndex);
-    if (it_l != learnedWords.end()) {
-        learnedWords.erase(it_l);
+    // 打开 CSV 记录文件，每帧一行
+    bool openTrace(const char* path) {
+        trace.open(path, std::ios::trunc);
+        if (!trace.is_open()) {
+            std::cerr << "无法创建帧耗时记录文件 " << path << std::endl;
+            return false;
+        }
+        trace.setf(std::ios::fixed);
+        trace.precision(3); // 精确到微秒
+        trace << "frame,kind,input_ms,draw_ms,flush_ms,latency_ms\n";
+        std::cout << "帧耗时记录写入 " << path << std::endl;
+        return true;
     }
 
-    // 根据新的熟悉度重新分类
-    if (newFamiliarity == 0) {
-        word.learned = false;
-        unlearnedWords.push_back(wordIndex);
+    // 取到一批输入消息后开始计时，处理完后结束
+    void beginInput() { inputStart = now(); }
+    void endInput() { pendingInputMs += elapsedMs(inputStart, now()); }
+
+    // 这批消息中有熟悉度按钮的点击。EasyX 的消息不带时间戳，以取出消息的时刻作为点击时刻
+    void markClick() {
+        if (clickTime == 0) clickTime = inputStart;
     }
-    else if (newFamiliarity < 3) {
-        word.learned = true;
-        learnedWords.push_back(wordIndex);
+
+    void beginDraw() { drawStart = now(); }
+    void endDraw() { drawEnd = now(); }
+    void beginFlush() { flushStart = now(); }
+
+    // 提交完成后调用，记录这一帧
+    void endFrame(bool full) {
+        int64_t end = now();
+        FrameRecord record;
+        record.inputMs = pendingInputMs;
+        record.drawMs = elapsedMs(drawStart, drawEnd);
+        record.flushMs = elapsedMs(flushStart, end);
+        record.latencyMs = -1;
+        if (clickTime != 0) {
+            record.latencyMs = elapsedMs(clickTime, end);
+            lastLatencyMs = record.latencyMs;
+            clickTime = 0;
+        }
+        pendingInputMs = 0;
+
+        history[historyNext] = record;
+        historyNext = (historyNext + 1) % HISTORY;
+        if (historyCount < HISTORY) historyCount++;
+
+        if (trace.is_open()) {
+            trace << frameIndex << ',' << (full ? "full" : "partial") << ',' << record.inputMs << ','
+                << record.drawMs << ',' << record.flushMs << ',';
+            if (record.latencyMs >= 0) trace << record.latencyMs;
+            trace << '\n';
+        }
+        frameIndex++;
     }
-    else {
-        word.learned = false; // 非常熟悉的单词不加入任何列表
+
+    DirtyRect overlayBounds() const {
+        return DirtyRect{ WINDOW_WIDTH - OVERLAY_WIDTH, 0, WINDOW_WIDTH - 1, OVERLAY_HEIGHT - 1 };
     }
-}
+
+    // 在右上角绘制最近若干帧的平均耗时和最近一次点击延迟
+    void drawOverlay() {
+        double input = 0, draw = 0, flush = 0;
+        for (int i = 0; i < historyCount; i++) {
+            input += history[i].inputMs;
+            draw += history[i].drawMs;
+            flush += history[i].flushMs;
+        }
+        if (historyCount > 0) {
+            input /= historyCount;
+            draw /= historyCount;
+            flush /= historyCount;
+        }
+
+        wchar_t lines[4][64];
+        std::swprintf(lines[0], 64, L"最近 %d 帧平均", historyCount);
+        std::swprintf(lines[1], 64, L"输入 %.2f ms  绘制 %.2f ms", input, draw);
+        std::swprintf(lines[2], 64, L"提交 %.2f ms", flush);
+        if (lastLatencyMs >= 0) {
+            std::swprintf(lines[3], 64, L"点击延迟 %.2f ms", lastLatencyMs);
+        }
+        else {
+            std::swprintf(lines[3], 64, L"点击延迟 --");
+        }
+
+        DirtyRect r = overlayBounds();
+        setfillcolor(Colors::Background);
+        setlinecolor(Colors::Subtitle);
+        setlinestyle(PS_SOLID, 1);
+        fillrectangle(r.left, r.top, r.right, r.bottom);
+
+        settextcolor(Colors::Title);
+        fontCache.select(15);
+        for (int i = 0; i < 4; i++) {
+            outtextxy(r.left + 8, r.top + 4 + i * 17, lines[i]);
+        }
+    }
+};
+
+FrameProfiler frameProfiler;
 
 // 修改后的主菜单界面
 class MainMenu {
 private:
     Button* btnLearnNew;
     Button* btnReview;
-    std::wstring statusText;
+    Button* btnSearch;
+    Button* btnQuiz;
+    wchar_t statusText[64]; // 状态栏文本，评分或回到主菜单时更新，绘制时不再格式化
+    CachedText title;
+    CachedText subtitle;
 
 public:
-    MainMenu() {
+    MainMenu() : title(L"词汇大师"), subtitle(L"每日进步一点点") {
         int btnWidth = 280;  // 加宽按钮
-        int btnHeight = 80;  // 增加高度
+        int btnHeight = 70;
         int centerX = (WINDOW_WIDTH - btnWidth) / 2;
 
-        // 垂直排列按钮，增加间距
-        btnLearnNew = new Button(centerX, 320, btnWidth, btnHeight, "学习新词",
+        // 垂直排列按钮，间距 20
+        btnLearnNew = new Button(centerX, 210, btnWidth, btnHeight, "学习新词",
             Colors::Familiar2, Colors::Familiar1, WHITE, 15);
-        btnReview = new Button(centerX, 420, btnWidth, btnHeight, "复习单词",
+        btnReview = new Button(centerX, 300, btnWidth, btnHeight, "复习单词",
             Colors::Familiar1, Colors::Familiar0, WHITE, 15);
+        btnSearch = new Button(centerX, 390, btnWidth, btnHeight, "查找单词",
+            Colors::Subtitle, Colors::Title, WHITE, 15);
+        btnQuiz = new Button(centerX, 480, btnWidth, btnHeight, "中译英测验",
+            Colors::Progress, Colors::Familiar2, WHITE, 15);
 
         updateStatusText();
     }
@@ -289,14 +697,13 @@ public:
     ~MainMenu() {
         delete btnLearnNew;
         delete btnReview;
+        delete btnSearch;
+        delete btnQuiz;
     }
 
     void updateStatusText() {
-        std::wstringstream ss;
-        ss << L"单词总数: " << wordLibrary.size()
-            << L"   待复习: " << learnedWords.size()
-            << L"   未学习: " << unlearnedWords.size();
-        statusText = ss.str();
+        std::swprintf(statusText, 64, L"单词总数: %zu   待复习: %zu   未学习: %zu", wordLibrary.size(),
+            wordLibrary.dueCount(static_cast<int64_t>(std::time(nullptr))), wordLibrary.unlearnedCount());
     }
 
     void draw() {
@@ -305,31 +712,42 @@ public:
 
         // 绘制标题
         settextcolor(Colors::Title);
-        settextstyle(48, 0, _T("微软雅黑"));
-        std::wstring title = L"词汇大师";
-        int titleWidth = textwidth(title.c_str());
-        outtextxy((WINDOW_WIDTH - titleWidth) / 2, 80, title.c_str());
+        fontCache.select(48);
+        title.measure(48);
+        outtextxy((WINDOW_WIDTH - title.width) / 2, 80, title.text.c_str());
 
         // 绘制副标题
         settextcolor(Colors::Subtitle);
-        settextstyle(24, 0, _T("微软雅黑"));
-        std::wstring subtitle = L"每日进步一点点";
-        int subtitleWidth = textwidth(subtitle.c_str());
-        outtextxy((WINDOW_WIDTH - subtitleWidth) / 2, 150, subtitle.c_str());
+        fontCache.select(24);
+        subtitle.measure(24);
+        outtextxy((WINDOW_WIDTH - subtitle.width) / 2, 150, subtitle.text.c_str());
 
         // 绘制状态文本
         settextcolor(Colors::Text);
-        settextstyle(18, 0, _T("微软雅黑"));
-        outtextxy(50, WINDOW_HEIGHT - 30, statusText.c_str());
+        fontCache.select(18);
+        outtextxy(50, WINDOW_HEIGHT - 30, statusText);
 
         // 绘制按钮
         btnLearnNew->draw();
         btnReview->draw();
+        btnSearch->draw();
+        btnQuiz->draw();
+    }
+
+    // 只重绘外观有变化的按钮
+    void drawDamaged(DamageTracker& damage) {
+        btnLearnNew->drawIfDirty(damage);
+        btnReview->drawIfDirty(damage);
+        btnSearch->drawIfDirty(damage);
+        btnQuiz->drawIfDirty(damage);
     }
 
-    void checkHover(int mx, int my) {
-        btnLearnNew->checkHover(mx, my);
-        btnReview->checkHover(mx, my);
+    bool checkHover(int mx, int my) {
+        bool changed = btnLearnNew->checkHover(mx, my);
+        changed |= btnReview->checkHover(mx, my);
+        changed |= btnSearch->checkHover(mx, my);
+        changed |= btnQuiz->checkHover(mx, my);
+        return changed;
     }
 
     int handleClick(int mx, int my) {
@@ -339,6 +757,12 @@ public:
         else if (btnReview->isClicked(mx, my)) {
             return 2; // 复习单词
         }
+        else if (btnSearch->isClicked(mx, my)) {
+            return 3; // 查找单词
+        }
+        else if (btnQuiz->isClicked(mx, my)) {
+            return 4; // 中译英测验
+        }
         return 0; // 无操作
     }
 };
@@ -356,9 +780,18 @@ private:
     int currentWordIndex;
     bool isReviewMode;
     std::wstring statusText;
+    CachedText wordText;     // 当前单词的宽字符文本
+    CachedText meaningText;  // 当前释义的宽字符文本（有详细信息时为全部释义）
+    CachedText phraseTexts[2]; // 卡片上显示的短语
+    int phraseCount;
+    CachedText emptyMessage; // 没有可用单词时的提示
+
+    // 卡片内文字的最大宽度
+    static const int CARD_TEXT_WIDTH = WINDOW_WIDTH - 240;
 
 public:
-    WordLearningScreen(bool reviewMode = false) : isReviewMode(reviewMode) {
+    WordLearningScreen(bool reviewMode = false) : isReviewMode(reviewMode), phraseCount(0),
+        emptyMessage(reviewMode ? L"没有需要复习的单词" : L"没有新单词可学习") {
         // 创建返回和下一个按钮
         btnBack = new Button(110, 500, 120, 50, "返回",
             Colors::addColor, Colors::ButtonHover, WHITE, 8);
@@ -395,13 +828,41 @@ public:
     // 重新加载当前单词
     void reloadCurrentWord() {
         if (isReviewMode) {
-            currentWordIndex = getRandomLearnedWord();
+            // 只复习已经到期的单词，最早到期的先出现
+            currentWordIndex = wordLibrary.getNextDueWord(static_cast<int64_t>(std::time(nullptr)));
             statusText = L"复习模式";
+            if (currentWordIndex < 0) {
+                emptyMessage.assign(nextReviewMessage().c_str());
+            }
         }
         else {
-            currentWordIndex = getRandomUnlearnedWord();
+            currentWordIndex = wordLibrary.getRandomUnlearnedWord();
             statusText = L"学习模式";
         }
+
+        // 每张卡片只转换一次，绘制时直接使用
+        phraseCount = 0;
+        if (currentWordIndex >= 0 && currentWordIndex < wordLibrary.size()) {
+            wordText.assign(wordLibrary[currentWordIndex].word);
+            meaningText.assign(wordLibrary[currentWordIndex].meaning);
+
+            // 第一次显示这张卡片时才读取详细信息；读不到时只显示第一个释义
+            const WordDetails* details = wordDetails.get(wordLibrary, currentWordIndex);
+            if (details != nullptr) {
+                std::string joined;
+                for (const WordTranslation& t : details->translations) {
+                    if (!joined.empty()) joined += "  ";
+                    if (!t.type.empty()) joined += t.type + ". ";
+                    joined += t.translation;
+                }
+                if (!joined.empty()) meaningText.assign(joined);
+
+                for (const WordPhrase& p : details->phrases) {
+                    if (phraseCount >= 2) break;
+                    phraseTexts[phraseCount++].assign(p.phrase + "  " + p.translation);
+                }
+            }
+        }
     }
 
     void draw() {
@@ -410,12 +871,10 @@ public:
 
         // 绘制状态文本
         settextcolor(Colors::Title);
-        settextstyle(24, 0, _T("微软雅黑"));
+        fontCache.select(24);
         outtextxy(50, 30, statusText.c_str());
 
         if (currentWordIndex >= 0 && currentWordIndex < wordLibrary.size()) {
-            Word& word = wordLibrary[currentWordIndex];
-
             // 绘制卡片背景
             setfillcolor(Colors::CardBg);
             fillroundrect(100, 120, WINDOW_WIDTH - 100, 340, 20, 20);
@@ -427,19 +886,27 @@ public:
 
             // 绘制单词
             settextcolor(Colors::Title);
-            settextstyle(64, 0, _T("微软雅黑"));
-            std::wstring wWord = utf8ToWstring(word.word);
-            int wordWidth = textwidth(wWord.c_str());
-            int wordX = (WINDOW_WIDTH - wordWidth) / 2;
-            outtextxy(wordX, 140, wWord.c_str());
+            fontCache.select(64);
+            wordText.measure(64);
+            int wordX = (WINDOW_WIDTH - wordText.width) / 2;
+            outtextxy(wordX, 140, wordText.text.c_str());
 
             // 绘制释义
             settextcolor(Colors::Text);
-            settextstyle(24, 0, _T("微软雅黑"));
-            std::wstring wMeaning = utf8ToWstring(word.meaning);
-            int meaningWidth = textwidth(wMeaning.c_str());
-            int meaningX = (WINDOW_WIDTH - meaningWidth) / 2;
-            outtextxy(meaningX, 240, wMeaning.c_str());
+            fontCache.select(24);
+            meaningText.fit(24, CARD_TEXT_WIDTH);
+            int meaningX = (WINDOW_WIDTH - meaningText.width) / 2;
+            outtextxy(meaningX, 240, meaningText.text.c_str());
+
+            // 绘制短语
+            if (phraseCount > 0) {
+                settextcolor(Colors::Subtitle);
+                fontCache.select(18);
+                for (int i = 0; i < phraseCount; i++) {
+                    phraseTexts[i].fit(18, CARD_TEXT_WIDTH);
+                    outtextxy((WINDOW_WIDTH - phraseTexts[i].width) / 2, 280 + i * 28, phraseTexts[i].text.c_str());
+                }
+            }
 
             // 绘制熟悉度按钮
             btnFamiliarity0->draw();
@@ -450,10 +917,9 @@ public:
         else {
             // 没有可用单词的提示
             settextcolor(Colors::Text);
-            settextstyle(28, 0, _T("微软雅黑"));
-            std::wstring message = isReviewMode ? L"没有需要复习的单词" : L"没有新单词可学习";
-            int msgWidth = textwidth(message.c_str());
-            outtextxy((WINDOW_WIDTH - msgWidth) / 2, 200, message.c_str());
+            fontCache.select(28);
+            emptyMessage.measure(28);
+            outtextxy((WINDOW_WIDTH - emptyMessage.width) / 2, 200, emptyMessage.text.c_str());
         }
 
         // 绘制返回和下一个按钮
@@ -461,16 +927,29 @@ public:
         btnNext->draw();
     }
 
-    void checkHover(int mx, int my) {
-        btnBack->checkHover(mx, my);
-        btnNext->checkHover(mx, my);
+    // 只重绘外观有变化的按钮；卡片内容变化时由主循环整屏重绘
+    void drawDamaged(DamageTracker& damage) {
+        if (currentWordIndex >= 0 && currentWordIndex < wordLibrary.size()) {
+            btnFamiliarity0->drawIfDirty(damage);
+            btnFamiliarity1->drawIfDirty(damage);
+            btnFamiliarity2->drawIfDirty(damage);
+            btnFamiliarity3->drawIfDirty(damage);
+        }
+        btnBack->drawIfDirty(damage);
+        btnNext->drawIfDirty(damage);
+    }
+
+    bool checkHover(int mx, int my) {
+        bool changed = btnBack->checkHover(mx, my);
+        changed |= btnNext->checkHover(mx, my);
 
         if (currentWordIndex >= 0 && currentWordIndex < wordLibrary.size()) {
-            btnFamiliarity0->checkHover(mx, my);
-            btnFamiliarity1->checkHover(mx, my);
-            btnFamiliarity2->checkHover(mx, my);
-            btnFamiliarity3->checkHover(mx, my);
+            changed |= btnFamiliarity0->checkHover(mx, my);
+            changed |= btnFamiliarity1->checkHover(mx, my);
+            changed |= btnFamiliarity2->checkHover(mx, my);
+            changed |= btnFamiliarity3->checkHover(mx, my);
         }
+        return changed;
     }
 
     int handleClick(int mx, int my, MainMenu* mainMenu) {
@@ -478,18 +957,29 @@ public:
             return 0; // 返回主菜单
         }
 
+        bool rated = false;
         if (currentWordIndex >= 0 && currentWordIndex < wordLibrary.size()) {
+            int familiarity = -1;
             if (btnFamiliarity0->isClicked(mx, my)) {
-                updateWordStatus(currentWordIndex, 0);
+                familiarity = 0;
             }
             else if (btnFamiliarity1->isClicked(mx, my)) {
-                updateWordStatus(currentWordIndex, 1);
+                familiarity = 1;
             }
             else if (btnFamiliarity2->isClicked(mx, my)) {
-                updateWordStatus(currentWordIndex, 2);
+                familiarity = 2;
             }
             else if (btnFamiliarity3->isClicked(mx, my)) {
-                updateWordStatus(currentWordIndex, 3);
+                familiarity = 3;
+            }
+            if (familiarity >= 0) {
+                rateWord(currentWordIndex, familiarity);
+                rated = true;
+            }
+            else if (isReviewMode && btnNext->isClicked(mx, my)) {
+                // 没有评分就跳过：推迟这张卡片，否则堆顶仍是它，会再次出现
+                wordLibrary.postponeReview(currentWordIndex,
+                    static_cast<int64_t>(std::time(nullptr)) + REVIEW_SKIP_SECONDS);
             }
 
             // 更新主菜单状态
@@ -499,95 +989,668 @@ public:
             reloadCurrentWord();
         }
 
-        return 1; // 继续在当前界面
+        return rated ? 2 : 1; // 继续在当前界面，2 表示刚评了分
     }
 };
 
-int main() {
-    SetConsoleOutputCP(65001);
-    // 尝试加载单词库
-    if (!loadWordLibraryFromJSON()) {
-        std::cout << "使用示例单词库..." << std::endl;
+// 查找单词界面：输入单词的开头，每输入一个字符就用前缀索引查找一次，
+// 列出按字母顺序的前几个单词、释义和学习状态。输入汉字时改为在释义倒排索引中查找（中译英），
+// 没有以输入开头的单词时列出拼写相近的单词
+class SearchScreen {
+private:
+    static const int MAX_RESULTS = 8;
+    static const size_t MAX_QUERY_LENGTH = 32;
+    static const int ROW_TOP = 180;
+    static const int ROW_HEIGHT = 44;
+
+    struct ResultRow {
+        CachedText word;
+        CachedText meaning;
+        CachedText status;
+        COLORREF statusColor;
+    };
+
+    Button* btnBack;
+    std::wstring query;       // 输入的英文前缀或中文释义
+    CachedText queryText;     // 输入框中显示的文字（带光标）
+    CachedText title;
+    CachedText placeholder;
+    std::wstring summaryText; // 匹配数和查找用时
+    std::vector<int> results; // 缓冲区重复使用
+    std::vector<FuzzyMatch> suggestions; // 拼写相近的单词
+    ResultRow rows[MAX_RESULTS];
+    int rowCount;
+
+    // 按当前输入查找并准备显示的文字
+    void runSearch() {
+        queryText.assign((query + L"|").c_str());
+        rowCount = 0;
+        if (query.empty()) {
+            summaryText = L"输入单词的开头（如 aban）或中文释义（如 放弃）";
+            return;
+        }
+
+        bool chinese = std::any_of(query.begin(), query.end(), isHanChar);
+        std::string key = wstringToUtf8(query);
+        if (chinese) getMeaningIndex(); // 第一次用时建立，不计入查找用时
+
+        auto startTime = std::chrono::steady_clock::now();
+        size_t matches = chinese ? meaningIndex.search(key, MAX_RESULTS, results)
+            : wordLibrary.searchPrefix(key, MAX_RESULTS, results);
+        size_t similar = 0;
+        if (matches == 0 && !chinese) {
+            // 没有以输入开头的单词时列出拼写相近的单词，短的单词只允许错一个字母
+            int maxDistance = query.size() <= 4 ? 1 : 2;
+            similar = wordLibrary.searchSimilar(key, maxDistance, MAX_RESULTS, suggestions);
+            for (const FuzzyMatch& match : suggestions) {
+                results.push_back(match.index);
+            }
+        }
+        double us = std::chrono::duration<double, std::micro>(std::chrono::steady_clock::now() - startTime).count();
+
+        wchar_t buffer[64];
+        if (similar > 0) {
+            std::swprintf(buffer, 64, L"没有找到，你是不是要找：（%zu 个相近的单词，用时 %.1f 微秒）", similar, us);
+        }
+        else {
+            std::swprintf(buffer, 64, L"找到 %zu 个单词，用时 %.1f 微秒", matches, us);
+        }
+        summaryText = buffer;
+
+        static const wchar_t* const familiarityNames[] = { L"未学习", L"一般", L"熟悉", L"非常熟悉" };
+        static const COLORREF familiarityColors[] = { Colors::Subtitle, Colors::Familiar1, Colors::Familiar2, Colors::Familiar2 };
+        for (int index : results) {
+            Word word = wordLibrary[index];
+            ResultRow& row = rows[rowCount++];
+            row.word.assign(word.word);
+            row.meaning.assign(word.meaning);
+            row.status.assign(familiarityNames[word.familiarity]);
+            row.statusColor = familiarityColors[word.familiarity];
+        }
+    }
+
+public:
+    SearchScreen() : title(L"查找单词"), placeholder(L"输入英文单词或中文释义"), rowCount(0) {
+        btnBack = new Button(225, 570, 120, 50, "返回",
+            Colors::addColor, Colors::ButtonHover, WHITE, 8);
+        runSearch();
+    }
+
+    ~SearchScreen() {
+        delete btnBack;
+    }
+
+    // 进入界面时清空输入
+    void reset() {
+        query.clear();
+        runSearch();
+    }
+
+    void draw() {
+        setbkcolor(Colors::Background);
+        cleardevice();
+
+        settextcolor(Colors::Title);
+        fontCache.select(24);
+        outtextxy(50, 30, title.text.c_str());
+
+        // 输入框
+        setfillcolor(Colors::CardBg);
+        setlinecolor(Colors::ButtonHover);
+        setlinestyle(PS_SOLID, 1);
+        fillroundrect(50, 80, WINDOW_WIDTH - 50, 130, 10, 10);
+        fontCache.select(28);
+        if (query.empty()) {
+            settextcolor(Colors::Subtitle);
+            outtextxy(65, 90, placeholder.text.c_str());
+        }
+        else {
+            settextcolor(Colors::Title);
+            outtextxy(65, 90, queryText.text.c_str());
+        }
+
+        settextcolor(Colors::Subtitle);
+        fontCache.select(18);
+        outtextxy(55, 145, summaryText.c_str());
+
+        // 结果列表：单词、释义、状态各一列。同一字号的列一起画，每帧只切换两次字体
+        settextcolor(Colors::Title);
+        fontCache.select(24);
+        for (int i = 0; i < rowCount; i++) {
+            rows[i].word.fit(24, 170);
+            outtextxy(60, ROW_TOP + i * ROW_HEIGHT, rows[i].word.text.c_str());
+        }
+        fontCache.select(18);
+        for (int i = 0; i < rowCount; i++) {
+            int y = ROW_TOP + i * ROW_HEIGHT + 4;
+            settextcolor(Colors::Text);
+            rows[i].meaning.fit(18, 180);
+            outtextxy(240, y, rows[i].meaning.text.c_str());
+
+            settextcolor(rows[i].statusColor);
+            rows[i].status.measure(18);
+            outtextxy(WINDOW_WIDTH - 60 - rows[i].status.width, y, rows[i].status.text.c_str());
+        }
+
+        btnBack->draw();
+    }
+
+    void drawDamaged(DamageTracker& damage) {
+        btnBack->drawIfDirty(damage);
+    }
+
+    bool checkHover(int mx, int my) {
+        return btnBack->checkHover(mx, my);
+    }
+
+    // 返回 0 表示回到主菜单
+    int handleClick(int mx, int my) {
+        if (btnBack->isClicked(mx, my)) {
+            return 0;
+        }
+        return 1;
+    }
+
+    // 处理输入的字符：返回 0 表示回到主菜单（Esc），1 表示输入变化需要重绘，2 表示忽略
+    int handleChar(wchar_t ch) {
+        if (ch == 27) {
+            return 0;
+        }
+        if (ch == L'\b') {
+            if (query.empty()) return 2;
+            query.pop_back();
+        }
+        else if ((ch >= L'a' && ch <= L'z') || (ch >= L'A' && ch <= L'Z') || ch == L'-' || ch == L'\'' || ch == L' ' ||
+            isHanChar(ch)) {
+            if (query.size() >= MAX_QUERY_LENGTH) return 2;
+            query.push_back(ch);
+        }
+        else {
+            return 2;
+        }
+        runSearch();
+        return 1;
+    }
+};
+
+// 中译英测验：显示一个单词的中文释义，从四个英文单词中选出对应的一个。
+// 干扰项优先从释义里有相同汉字的单词中挑选（在释义倒排索引中查找），比随机单词更难区分
+class ReverseQuizScreen {
+private:
+    static const int OPTION_COUNT = 4;
+    static const int CARD_TEXT_WIDTH = WINDOW_WIDTH - 240;
+
+    Button* btnBack;
+    Button* options[OPTION_COUNT];
+    int optionWords[OPTION_COUNT];
+    int correctOption;
+    int targetWord;           // -1 表示单词太少，无法出题
+    CachedText title;
+    CachedText meaningText;
+    CachedText feedbackText;  // 上一题的结果
+    CachedText emptyMessage;
+    COLORREF feedbackColor;
+    std::vector<int> candidates; // 缓冲区重复使用
+    std::mt19937 gen;
+
+    // 能否作为干扰项：不能和已选的重复，也不能和答案的单词或释义相同
+    bool isDistractor(int index, int filled) const {
+        for (int i = 0; i < filled; i++) {
+            if (optionWords[i] == index) return false;
+        }
+        Word target = wordLibrary[targetWord];
+        Word word = wordLibrary[index];
+        return word.meaning != target.meaning && word.word != target.word;
+    }
+
+    // 出下一题
+    void nextQuestion() {
+        int count = static_cast<int>(wordLibrary.size());
+        if (count < OPTION_COUNT) {
+            targetWord = -1;
+            return;
+        }
+
+        // 优先考已学过的单词
+        targetWord = wordLibrary.getRandomLearnedWord();
+        if (targetWord < 0) targetWord = wordLibrary.getRandomUnlearnedWord();
+        if (targetWord < 0) targetWord = std::uniform_int_distribution<int>(0, count - 1)(gen);
+        Word target = wordLibrary[targetWord];
+        meaningText.assign(target.meaning);
+
+        int filled = 0;
+        optionWords[filled++] = targetWord;
+
+        // 按随机顺序取释义中的汉字，找释义里也有这个字的单词
+        std::vector<wchar_t> hanChars;
+        for (wchar_t ch : utf8ToWstring(target.meaning)) {
+            if (isHanChar(ch)) hanChars.push_back(ch);
+        }
+        std::shuffle(hanChars.begin(), hanChars.end(), gen);
+        const MeaningIndex& index = getMeaningIndex();
+        for (wchar_t ch : hanChars) {
+            if (filled == OPTION_COUNT) break;
+            index.search(wstringToUtf8(std::wstring(1, ch)), 1024, candidates);
+            std::shuffle(candidates.begin(), candidates.end(), gen);
+            for (int c : candidates) {
+                if (filled == OPTION_COUNT) break;
+                if (isDistractor(c, filled)) optionWords[filled++] = c;
+            }
+        }
+
+        // 不够时用随机单词补齐；词库里释义都相同时最后按顺序取
+        std::uniform_int_distribution<int> any(0, count - 1);
+        for (int attempt = 0; filled < OPTION_COUNT && attempt < 1000; attempt++) {
+            int c = any(gen);
+            if (isDistractor(c, filled)) optionWords[filled++] = c;
+        }
+        for (int c = 0; filled < OPTION_COUNT && c < count; c++) {
+            if (std::find(optionWords, optionWords + filled, c) == optionWords + filled) optionWords[filled++] = c;
+        }
+
+        std::shuffle(optionWords, optionWords + OPTION_COUNT, gen);
+        for (int i = 0; i < OPTION_COUNT; i++) {
+            if (optionWords[i] == targetWord) correctOption = i;
+            options[i]->setText(std::string(wordLibrary[optionWords[i]].word));
+        }
+    }
+
+public:
+    ReverseQuizScreen() : correctOption(0), targetWord(-1), title(L"中译英测验"),
+        emptyMessage(L"单词太少，无法出题"), feedbackColor(Colors::Subtitle), gen(std::random_device{}()) {
+        btnBack = new Button(225, 565, 120, 50, "返回",
+            Colors::addColor, Colors::ButtonHover, WHITE, 8);
+        int btnWidth = 330;
+        for (int i = 0; i < OPTION_COUNT; i++) {
+            options[i] = new Button((WINDOW_WIDTH - btnWidth) / 2, 290 + i * 65, btnWidth, 55, "",
+                Colors::Subtitle, Colors::Title, WHITE, 10);
+            optionWords[i] = -1;
+        }
+    }
+
+    ~ReverseQuizScreen() {
+        delete btnBack;
+        for (int i = 0; i < OPTION_COUNT; i++) {
+            delete options[i];
+        }
+    }
+
+    // 进入界面时出第一题
+    void reset() {
+        feedbackText.assign(L"选出与释义对应的单词");
+        feedbackColor = Colors::Subtitle;
+        nextQuestion();
+    }
+
+    void draw() {
+        setbkcolor(Colors::Background);
+        cleardevice();
+
+        settextcolor(Colors::Title);
+        fontCache.select(24);
+        outtextxy(50, 30, title.text.c_str());
+
+        if (targetWord >= 0) {
+            // 释义卡片
+            setfillcolor(Colors::CardBg);
+            fillroundrect(100, 90, WINDOW_WIDTH - 100, 230, 20, 20);
+            settextcolor(Colors::Title);
+            fontCache.select(32);
+            meaningText.fit(32, CARD_TEXT_WIDTH);
+            outtextxy((WINDOW_WIDTH - meaningText.width) / 2, 142, meaningText.text.c_str());
+
+            settextcolor(feedbackColor);
+            fontCache.select(18);
+            feedbackText.fit(18, CARD_TEXT_WIDTH);
+            outtextxy((WINDOW_WIDTH - feedbackText.width) / 2, 250, feedbackText.text.c_str());
+
+            for (int i = 0; i < OPTION_COUNT; i++) {
+                options[i]->draw();
+            }
+        }
+        else {
+            settextcolor(Colors::Text);
+            fontCache.select(28);
+            emptyMessage.measure(28);
+            outtextxy((WINDOW_WIDTH - emptyMessage.width) / 2, 200, emptyMessage.text.c_str());
+        }
+
+        btnBack->draw();
+    }
+
+    void drawDamaged(DamageTracker& damage) {
+        if (targetWord >= 0) {
+            for (int i = 0; i < OPTION_COUNT; i++) {
+                options[i]->drawIfDirty(damage);
+            }
+        }
+        btnBack->drawIfDirty(damage);
+    }
+
+    bool checkHover(int mx, int my) {
+        bool changed = btnBack->checkHover(mx, my);
+        if (targetWord >= 0) {
+            for (int i = 0; i < OPTION_COUNT; i++) {
+                changed |= options[i]->checkHover(mx, my);
+            }
+        }
+        return changed;
+    }
+
+    // 返回 0 表示回到主菜单，1 表示留在当前界面，2 表示刚答了一题
+    int handleClick(int mx, int my, MainMenu* mainMenu) {
+        if (btnBack->isClicked(mx, my)) {
+            return 0;
+        }
+        if (targetWord < 0) {
+            return 1;
+        }
 
-        Word w1; w1.word = "apple"; w1.meaning = "苹果";
-        Word w2; w2.word = "banana"; w2.meaning = "香蕉";
-        Word w3; w3.word = "cherry"; w3.meaning = "樱桃";
-        Word w4; w4.word = "dog"; w4.meaning = "狗";
-        Word w5; w5.word = "elephant"; w5.meaning = "大象";
+        for (int i = 0; i < OPTION_COUNT; i++) {
+            if (!options[i]->isClicked(mx, my)) continue;
 
-        wordLibrary = { w1, w2, w3, w4, w5 };
+            // 答对记为"熟悉"，答错记为"不熟悉"，和学习界面的评分走同一条路径
+            Word target = wordLibrary[targetWord];
+            std::string answer(target.word);
+            if (i == correctOption) {
+                rateWord(targetWord, 2);
+                feedbackText.assign("回答正确: " + answer);
+                feedbackColor = Colors::Familiar2;
+            }
+            else {
+                rateWord(targetWord, 0);
+                feedbackText.assign("回答错误，正确答案是 " + answer);
+                feedbackColor = Colors::Familiar0;
+            }
+            mainMenu->updateStatusText();
+            nextQuestion();
+            return 2;
+        }
+        return 1;
+    }
+};
+
+// 输入事件
+struct InputEvent {
+    enum Type { Move, Click, Key, Char } type;
+    int x, y;
+    int key; // Key 事件的虚拟键码，Char 事件的字符
+};
+
+// 输入分发器：每次把消息队列中的鼠标、按键和字符消息全部取出，
+// 连续的移动消息合并为最后一条，点击按到达顺序全部保留
+class InputDispatcher {
+private:
+    std::vector<InputEvent> events; // 本次取出的事件，缓冲区重复使用
+
+    void push(const ExMessage& msg) {
+        if (msg.message == WM_MOUSEMOVE) {
+            if (!events.empty() && events.back().type == InputEvent::Move) {
+                events.back().x = msg.x;
+                events.back().y = msg.y;
+                coalescedMoves++;
+                return;
+            }
+            events.push_back({ InputEvent::Move, msg.x, msg.y, 0 });
+        }
+        else if (msg.message == WM_LBUTTONDOWN) {
+            events.push_back({ InputEvent::Click, msg.x, msg.y, 0 });
+        }
+        else if (msg.message == WM_KEYDOWN) {
+            events.push_back({ InputEvent::Key, 0, 0, msg.vkcode });
+        }
+        else if (msg.message == WM_CHAR) {
+            events.push_back({ InputEvent::Char, 0, 0, msg.ch });
+        }
+    }
+
+public:
+    long long coalescedMoves = 0; // 被合并掉的移动消息数
+
+    // 阻塞直到至少有一条消息，然后取出队列中剩余的所有消息
+    const std::vector<InputEvent>& poll() {
+        events.clear();
+        ExMessage msg = getmessage(EX_MOUSE | EX_KEY | EX_CHAR);
+        push(msg);
+        while (peekmessage(&msg, EX_MOUSE | EX_KEY | EX_CHAR)) {
+            push(msg);
+        }
+        return events;
+    }
+};
+
+InputDispatcher inputDispatcher;
+
+// 调试开关：按 F9 在每个局部重绘的区域上画红框，按 F10 显示帧耗时
+const int DAMAGE_OVERLAY_KEY = VK_F9;
+const int PROFILER_OVERLAY_KEY = VK_F10;
+
+int main(int argc, char* argv[]) {
+    SetConsoleOutputCP(65001);
+
+    // 转换模式: 只把 words.json 编译成二进制快照，不打开窗口
+    if (argc > 1 && std::strcmp(argv[1], "--build-snapshot") == 0) {
+        showStats = true;
+        if (!loadWordLibraryFromJSON() || !wordLibrary.saveSnapshot(WORDS_SNAPSHOT_PATH)) {
+            return 1;
+        }
+        std::cout << "已生成词库快照 " << WORDS_SNAPSHOT_PATH << std::endl;
+        return 0;
+    }
 
-        // 初始化单词状态
-        unlearnedWords.clear();
-        learnedWords.clear();
-        for (size_t i = 0; i < wordLibrary.size(); i++) {
-            wordLibrary[i].familiarity = 0;
-            wordLibrary[i].learned = false;
-            unlearnedWords.push_back(i);
+    // --trace [文件名]: 把每帧的耗时写入 CSV 文件
+    // --stats: 在控制台输出统计信息
+    for (int i = 1; i < argc; i++) {
+        if (std::strcmp(argv[i], "--trace") == 0) {
+            const char* path = i + 1 < argc && argv[i + 1][0] != '-' ? argv[i + 1] : "frame_trace.csv";
+            frameProfiler.openTrace(path);
         }
+        else if (std::strcmp(argv[i], "--stats") == 0) {
+            showStats = true;
+        }
+    }
+
+    // 尝试加载单词库
+    if (!loadWordLibrary()) {
+        std::cout << "使用示例单词库..." << std::endl;
+
+        SnapshotBuilder builder;
+        builder.add("apple", "苹果", 0);
+        builder.add("banana", "香蕉", 0);
+        builder.add("cherry", "樱桃", 0);
+        builder.add("dog", "狗", 0);
+        builder.add("elephant", "大象", 0);
+        wordLibrary.loadFromImage(builder.finish());
     }
+    wordDetails.setSource(WORDS_JSON_PATH);
+
+    // 恢复保存的学习进度
+    restoreProgress();
 
     // 初始化图形窗口
     initgraph(WINDOW_WIDTH, WINDOW_HEIGHT);
+    setbkmode(TRANSPARENT); // 文字背景透明，卡片上的文字不带背景色块
     BeginBatchDraw();
 
     // 创建界面对象
     MainMenu mainMenu;
+    SearchScreen searchScreen;
+    ReverseQuizScreen quizScreen;
     WordLearningScreen* currentLearningScreen = nullptr;
 
-    int currentScreen = 0; // 0-主菜单，1-学习，2-复习
+    int currentScreen = 0; // 0-主菜单，1-学习，2-复习，3-查找，4-中译英测验
+    int drawnScreen = 0;   // 上次整屏重绘的界面
     bool running = true;
+    bool needRedraw = true;   // 界面内容变化（切换界面、换卡片），需要整屏重绘
+    bool needRepaint = false; // 只有按钮外观变化，只重绘这些按钮
+    bool showDamage = false;  // 是否显示局部重绘区域
+    bool showProfiler = false; // 是否显示帧耗时浮层
+    DamageTracker damage;
 
     while (running) {
-        if (MouseHit()) {
-            MOUSEMSG msg = GetMouseMsg();
+        // 只在状态变化后重绘
+        if (needRedraw) {
+            // 到期的单词数随时间增加：从其他界面回到主菜单时重新统计，停留在主菜单时不再统计
+            if (currentScreen == 0 && drawnScreen != 0) {
+                mainMenu.updateStatusText();
+            }
+            drawnScreen = currentScreen;
+
+            fontCache.beginFrame();
+            frameProfiler.beginDraw();
+            cleardevice();
+
+            if (currentScreen == 0) {
+                mainMenu.draw();
+            }
+            else if (currentScreen == 3) {
+                searchScreen.draw();
+            }
+            else if (currentScreen == 4) {
+                quizScreen.draw();
+            }
+            else {
+                if (currentLearningScreen) currentLearningScreen->draw();
+            }
+            frameProfiler.endDraw();
+            if (showProfiler) {
+                frameProfiler.drawOverlay();
+            }
+
+            frameProfiler.beginFlush();
+            FlushBatchDraw();
+            frameProfiler.endFrame(true);
+            fontCache.endFrame();
+            frameCounter.drawn++;
+            needRedraw = false;
+            needRepaint = false;
+        }
+        else if (needRepaint) {
+            fontCache.beginFrame();
+            frameProfiler.beginDraw();
+            damage.clear();
+            if (currentScreen == 0) {
+                mainMenu.drawDamaged(damage);
+            }
+            else if (currentScreen == 3) {
+                searchScreen.drawDamaged(damage);
+            }
+            else if (currentScreen == 4) {
+                quizScreen.drawDamaged(damage);
+            }
+            else if (currentLearningScreen) {
+                currentLearningScreen->drawDamaged(damage);
+            }
+            frameProfiler.endDraw();
+            if (showProfiler) {
+                frameProfiler.drawOverlay();
+                damage.add(frameProfiler.overlayBounds());
+            }
 
-            if (msg.uMsg == WM_LBUTTONDOWN) {
+            // 只把重绘过的区域提交到窗口
+            frameProfiler.beginFlush();
+            for (const DirtyRect& r : damage.regions()) {
+                if (showDamage) {
+                    setlinecolor(Colors::DirtyOverlay);
+                    setlinestyle(PS_SOLID, 1);
+                    rectangle(r.left, r.top, r.right, r.bottom);
+                }
+                FlushBatchDraw(r.left, r.top, r.right, r.bottom);
+            }
+            frameProfiler.endFrame(false);
+            fontCache.endFrame();
+            frameCounter.partial++;
+            frameCounter.regions += damage.regions().size();
+            needRepaint = false;
+        }
+
+        // 阻塞等待鼠标消息，空闲时不占用CPU；一次取出队列中的全部消息按顺序处理
+        const std::vector<InputEvent>& events = inputDispatcher.poll();
+        frameProfiler.beginInput();
+        for (const InputEvent& event : events) {
+            if (event.type == InputEvent::Key) {
+                if (event.key == DAMAGE_OVERLAY_KEY) {
+                    showDamage = !showDamage;
+                    needRedraw = true; // 整屏重绘，清掉之前留下的红框
+                }
+                else if (event.key == PROFILER_OVERLAY_KEY) {
+                    showProfiler = !showProfiler;
+                    needRedraw = true;
+                }
+            }
+            else if (event.type == InputEvent::Char) {
+                if (currentScreen == 3) {
+                    int result = searchScreen.handleChar(static_cast<wchar_t>(event.key));
+                    if (result == 0) currentScreen = 0;
+                    if (result != 2) needRedraw = true;
+                }
+            }
+            else if (event.type == InputEvent::Click) {
                 if (currentScreen == 0) { // 主菜单
-                    int action = mainMenu.handleClick(msg.x, msg.y);
+                    int action = mainMenu.handleClick(event.x, event.y);
                     if (action == 1) { // 学习新词
                         delete currentLearningScreen;
                         currentLearningScreen = new WordLearningScreen(false);
                         currentScreen = 1;
+                        needRedraw = true;
                     }
                     else if (action == 2) { // 复习
                         delete currentLearningScreen;
                         currentLearningScreen = new WordLearningScreen(true);
                         currentScreen = 2;
+                        needRedraw = true;
+                    }
+                    else if (action == 3) { // 查找
+                        searchScreen.reset();
+                        currentScreen = 3;
+                        needRedraw = true;
+                    }
+                    else if (action == 4) { // 中译英测验
+                        quizScreen.reset();
+                        currentScreen = 4;
+                        needRedraw = true;
                     }
                 }
+                else if (currentScreen == 3) { // 查找界面
+                    if (searchScreen.handleClick(event.x, event.y) == 0) {
+                        currentScreen = 0;
+                        needRedraw = true;
+                    }
+                }
+                else if (currentScreen == 4) { // 测验界面
+                    int result = quizScreen.handleClick(event.x, event.y, &mainMenu);
+                    if (result == 0) currentScreen = 0;
+                    else if (result == 2) frameProfiler.markClick();
+                    if (result != 1) needRedraw = true;
+                }
                 else { // 学习/复习界面
-                    int result = currentLearningScreen->handleClick(msg.x, msg.y, &mainMenu);
+                    int result = currentLearningScreen->handleClick(event.x, event.y, &mainMenu);
                     if (result == 0) currentScreen = 0;
+                    else if (result == 2) frameProfiler.markClick();
+                    needRedraw = true;
                 }
             }
-        }
-
-        // 鼠标悬停检测
-        if (MouseHit()) {
-            MOUSEMSG msg = GetMouseMsg();
-            if (msg.uMsg == WM_MOUSEMOVE) {
+            else { // 鼠标悬停检测
                 if (currentScreen == 0) {
-                    mainMenu.checkHover(msg.x, msg.y);
+                    needRepaint |= mainMenu.checkHover(event.x, event.y);
+                }
+                else if (currentScreen == 3) {
+                    needRepaint |= searchScreen.checkHover(event.x, event.y);
+                }
+                else if (currentScreen == 4) {
+                    needRepaint |= quizScreen.checkHover(event.x, event.y);
                 }
                 else {
-                    currentLearningScreen->checkHover(msg.x, msg.y);
+                    needRepaint |= currentLearningScreen->checkHover(event.x, event.y);
                 }
             }
         }
 
-        // 绘制当前界面
-        cleardevice();
+        frameProfiler.endInput();
 
-        if (currentScreen == 0) {
-            mainMenu.draw();
+        if (!needRedraw && !needRepaint) {
+            frameCounter.skipped++;
         }
-        else {
-            if (currentLearningScreen) currentLearningScreen->draw();
-        }
-
-        FlushBatchDraw();
-        Sleep(10);
     }
 
     // 清理资源